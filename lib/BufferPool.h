@@ -0,0 +1,141 @@
+#ifndef BORON_BUFFERPOOL_H_
+#define BORON_BUFFERPOOL_H_
+
+#include <cstddef>
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Buffers.h"
+
+/***
+ * Thread-safe pool of DynamicOutputBuffers. Leased buffers keep the capacity they grew to while encoding
+ * earlier messages, so encoding at a high rate does not allocate. Buffers that grew beyond the high-water
+ * mark are trimmed down to it when they are returned, so a single huge message does not pin its memory.
+ */
+class OutputBufferPool
+{
+public:
+    /***
+     * A buffer leased from the pool, it is cleared and returned to the pool when the lease is destroyed.
+     */
+    class Lease
+    {
+    public:
+        friend OutputBufferPool;
+
+        Lease(const Lease&) = delete;
+
+        Lease(Lease&& other) :
+            _pool(std::exchange(other._pool, nullptr)), _buffer(std::move(other._buffer)) {}
+
+        ~Lease()
+        {
+            if (_pool != nullptr)
+            {
+                _pool->release(std::move(_buffer));
+            }
+        }
+
+        Lease& operator=(const Lease&) = delete;
+
+        Lease& operator=(Lease&&) = delete;
+
+        DynamicOutputBuffer& operator*()
+        {
+            return *_buffer;
+        }
+
+        DynamicOutputBuffer* operator->()
+        {
+            return _buffer.get();
+        }
+
+        DynamicOutputBuffer& get()
+        {
+            return *_buffer;
+        }
+
+    private:
+        Lease(OutputBufferPool* pool, std::unique_ptr<DynamicOutputBuffer> buffer) :
+            _pool(pool), _buffer(std::move(buffer)) {}
+
+        OutputBufferPool* _pool = nullptr;
+
+        std::unique_ptr<DynamicOutputBuffer> _buffer;
+    };
+
+    static constexpr size_t DEFAULT_HIGH_WATER_MARK = 1024 * 1024;
+
+    /***
+     * @param highWaterMark The maximum capacity a returned buffer keeps.
+     * @param maxIdle The maximum number of idle buffers kept, surplus buffers are freed.
+     */
+    explicit OutputBufferPool(size_t highWaterMark = DEFAULT_HIGH_WATER_MARK, size_t maxIdle = 64) :
+        _highWaterMark(highWaterMark), _maxIdle(maxIdle) {}
+
+    OutputBufferPool(const OutputBufferPool&) = delete;
+
+    OutputBufferPool& operator=(const OutputBufferPool&) = delete;
+
+    /***
+     * Lease an empty buffer, the pool must outlive the lease.
+     * 
+     * @return The lease.
+     */
+    Lease acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_buffers.empty() == false)
+            {
+                auto buffer = std::move(_buffers.back());
+                _buffers.pop_back();
+                return Lease(this, std::move(buffer));
+            }
+        }
+
+        return Lease(this, std::make_unique<DynamicOutputBuffer>());
+    }
+
+    /***
+     * Get the number of idle buffers.
+     * 
+     * @return The number of buffers currently held by the pool.
+     */
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _buffers.size();
+    }
+
+    size_t highWaterMark() const
+    {
+        return _highWaterMark;
+    }
+
+private:
+    void release(std::unique_ptr<DynamicOutputBuffer> buffer)
+    {
+        buffer->clear();
+        buffer->shrink(_highWaterMark);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_buffers.size() < _maxIdle)
+        {
+            _buffers.push_back(std::move(buffer));
+        }
+    }
+
+    const size_t _highWaterMark;
+
+    const size_t _maxIdle;
+
+    mutable std::mutex _mutex;
+
+    std::vector<std::unique_ptr<DynamicOutputBuffer>> _buffers;
+};
+
+#endif // BORON_BUFFERPOOL_H_
\ No newline at end of file
@@ -4,7 +4,27 @@
 #include <cstddef>
 
 #include <algorithm>
+#include <concepts>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define BORON_HAS_MMAP 1
+#define BORON_HAS_POSIX_IO 1
+#endif
 
 #include "cbor/Types.h"
 #include "Bytes.h"
@@ -16,31 +36,38 @@ public:
 
     virtual std::span<const uint8_t> readSpan(size_t n) = 0;
 
-    template <typename T>
-        requires(std::is_fundamental_v<T>)
+    template <Bytes::Swappable T>
     bool read(T& x, Bytes::Endianess endianness = Bytes::Endianess::NATIVE)
     {
-        union
+        const auto bytes = readSpan(sizeof(T));
+        if (bytes.size() != sizeof(T))
         {
-            T x;
+            return false;
+        }
 
-            std::array<uint8_t, sizeof(T)> bytes;
-        } cvt;
+        x = Bytes::load<T>(bytes.data(), endianness);
 
-        for (int i = 0; i < sizeof(T); ++i)
-        {
-            if (read(cvt.bytes[i]) == false)
-            {
-                return false;
-            }
-        }
+        return true;
+    }
 
-        if (endianness != Bytes::Endianess::NATIVE)
+    /***
+     * Read an array of values, converting the whole array from @p endianness at once.
+     * 
+     * @param values The destination in native byte order.
+     * @param endianness The byte order of the values in the buffer.
+     * 
+     * @return True if all values were read.
+     */
+    template <Bytes::Swappable T>
+    bool readArray(std::span<T> values, Bytes::Endianess endianness = Bytes::Endianess::NATIVE)
+    {
+        const auto bytes = readSpan(values.size() * sizeof(T));
+        if (bytes.size() != values.size() * sizeof(T))
         {
-            std::reverse(cvt.bytes.begin(), cvt.bytes.end());
+            return false;
         }
 
-        x = cvt.x;
+        Bytes::load(bytes, values, endianness);
 
         return true;
     }
@@ -51,42 +78,134 @@ public:
 class OutputBuffer
 {
 public:
-    virtual bool write(uint8_t x) = 0;
+    /***
+     * Acquire a contiguous, writable window of at least @p n bytes at the end of the buffer.
+     * The bytes only become part of the buffer once they are committed.
+     * 
+     * @param n The minimum number of bytes required.
+     * 
+     * @return The writable window, smaller than @p n if the buffer cannot provide enough space.
+     */
+    virtual std::span<uint8_t> acquire(size_t n) = 0;
+
+    /***
+     * Commit the first @p n bytes of the window returned by the last call to acquire().
+     * 
+     * @param n The number of bytes written, must not exceed the size of the acquired window.
+     */
+    virtual void commit(size_t n) = 0;
+
+    virtual bool write(uint8_t x)
+    {
+        const auto window = acquire(1);
+        if (window.empty())
+        {
+            return false;
+        }
+
+        window[0] = x;
+        commit(1);
+
+        return true;
+    }
 
     virtual bool write(std::span<const uint8_t> data, Bytes::Endianess endianess = Bytes::Endianess::NATIVE)
     {
-        for (size_t i = 0; i < data.size(); ++i)
+        const auto window = acquire(data.size());
+        if (window.size() < data.size())
         {
-            const auto index = endianess == Bytes::Endianess::NATIVE ? i : data.size() - i - 1;
-            if (write(data[index]) == false)
-            {
-                return false;
-            }
+            return false;
         }
 
+        std::copy(data.begin(), data.end(), window.begin());
+        if (endianess != Bytes::Endianess::NATIVE)
+        {
+            std::reverse(window.begin(), window.begin() + data.size());
+        }
+
+        commit(data.size());
+
         return true;
     }
 
-    template <typename T>
-        requires(std::is_fundamental_v<T>)
+    template <Bytes::Swappable T>
     bool write(const T& x, Bytes::Endianess endianess = Bytes::Endianess::NATIVE)
     {
-        auto bytes = Bytes::getBytes(x);
+        const auto window = acquire(sizeof(T));
+        if (window.size() < sizeof(T))
+        {
+            return false;
+        }
 
-        if (endianess != Bytes::Endianess::NATIVE)
+        Bytes::store(window.data(), x, endianess);
+        commit(sizeof(T));
+
+        return true;
+    }
+
+    /***
+     * Write an array of values, converting the whole array to @p endianess at once.
+     * 
+     * @param values The values in native byte order.
+     * @param endianess The byte order to write the values in.
+     * 
+     * @return True if all values were written.
+     */
+    template <Bytes::Swappable T>
+    bool writeArray(std::span<const T> values, Bytes::Endianess endianess = Bytes::Endianess::NATIVE)
+    {
+        // convert in bounded windows, so that block-staged buffers never need larger windows
+        constexpr size_t MAX_VALUES_PER_WINDOW = 4096 / sizeof(T);
+        while (values.empty() == false)
         {
-            std::reverse(bytes.begin(), bytes.end());
+            const auto count = std::min(values.size(), MAX_VALUES_PER_WINDOW);
+            const auto window = acquire(count * sizeof(T));
+            if (window.size() < count * sizeof(T))
+            {
+                return false;
+            }
+
+            Bytes::store(values.first(count), window, endianess);
+            commit(count * sizeof(T));
+
+            values = values.subspan(count);
         }
 
-        return write(bytes);
+        return true;
     }
 
     virtual size_t size() const = 0;
 };
 
-class SpanInputBuffer : public InputBuffer
+/***
+ * Compile-time interface of a buffer that can be decoded from. InputBuffer is the type-erased
+ * counterpart, templated code instantiated with a concrete (final) buffer inlines all calls.
+ */
+template <typename T>
+concept InputSource = requires(T& buffer, uint8_t& x, size_t n)
+{
+    { buffer.read(x) } -> std::same_as<bool>;
+    { buffer.readSpan(n) } -> std::same_as<std::span<const uint8_t>>;
+    { buffer.size() } -> std::convertible_to<size_t>;
+};
+
+/***
+ * Compile-time interface of a buffer that can be encoded to. OutputBuffer is the type-erased
+ * counterpart, templated code instantiated with a concrete (final) buffer inlines all calls.
+ */
+template <typename T>
+concept OutputSink = requires(T& buffer, size_t n)
+{
+    { buffer.acquire(n) } -> std::same_as<std::span<uint8_t>>;
+    { buffer.commit(n) };
+    { buffer.size() } -> std::convertible_to<size_t>;
+};
+
+class SpanInputBuffer final : public InputBuffer
 {
 public:
+    using InputBuffer::read;
+
     constexpr SpanInputBuffer(std::span<const uint8_t> data) :
         _data(data) {}
 
@@ -123,46 +242,518 @@ public:
         return _data.size();
     }
 
+    constexpr size_t remaining() const
+    {
+        return capacity() - size();
+    }
+
+    /***
+     * Get the next byte without consuming it.
+     * 
+     * @return The next byte, 0x00 if the buffer is exhausted.
+     */
+    constexpr uint8_t peek() const
+    {
+        return remaining() > 0 ? _data[_size] : 0x00;
+    }
+
+    /***
+     * Get the current position to return to with rewind(), e.g. before a speculative parse.
+     * 
+     * @return The mark.
+     */
+    constexpr size_t mark() const
+    {
+        return _size;
+    }
+
+    /***
+     * Return to a position obtained with mark(). Rewinding is free, nothing is copied.
+     * 
+     * @param mark The mark.
+     */
+    constexpr void rewind(size_t mark)
+    {
+        _size = std::min(mark, _size);
+    }
+
+    /***
+     * Carve out a bounded child buffer for the next @p length bytes (e.g. a length-delimited region)
+     * and skip them in this buffer. The child refers to the same memory.
+     * 
+     * @param length The number of bytes of the child.
+     * 
+     * @return The child buffer, empty if less than @p length bytes are left.
+     */
+    constexpr SpanInputBuffer slice(size_t length)
+    {
+        return SpanInputBuffer(readSpan(length));
+    }
+
+    /***
+     * Get the bytes that are not read yet.
+     * 
+     * @return The unread bytes.
+     */
+    constexpr std::span<const uint8_t> unread() const
+    {
+        return _data.subspan(_size);
+    }
+
 private:
     std::span<const uint8_t> _data;
 
     size_t _size = 0;
 };
 
-class SpanOutputBuffer : public OutputBuffer 
+/***
+ * Thread-safe pool of fixed-size chunks for segmented output buffers. Chunks released by one buffer are
+ * handed out again to the next one, so steady-state encoding does not allocate.
+ */
+class ChunkPool
 {
 public:
-    constexpr SpanOutputBuffer() = default;
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
 
-    constexpr SpanOutputBuffer(std::span<uint8_t> data) :
-        _data(data) {}
+    /***
+     * @param chunkSize The size of each chunk.
+     * @param maxChunks The maximum number of idle chunks kept, surplus chunks are freed.
+     */
+    explicit ChunkPool(size_t chunkSize = DEFAULT_CHUNK_SIZE, size_t maxChunks = 1024) :
+        _chunkSize(std::max<size_t>(chunkSize, 1)), _maxChunks(maxChunks) {}
+
+    ChunkPool(const ChunkPool&) = delete;
+
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    std::unique_ptr<uint8_t[]> acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_chunks.empty() == false)
+            {
+                auto chunk = std::move(_chunks.back());
+                _chunks.pop_back();
+                return chunk;
+            }
+        }
+
+        return std::make_unique_for_overwrite<uint8_t[]>(_chunkSize);
+    }
+
+    void release(std::unique_ptr<uint8_t[]> chunk)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_chunks.size() < _maxChunks)
+        {
+            _chunks.push_back(std::move(chunk));
+        }
+    }
+
+    size_t chunkSize() const
+    {
+        return _chunkSize;
+    }
+
+    /***
+     * Get the number of idle chunks.
+     * 
+     * @return The number of chunks currently held by the pool.
+     */
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _chunks.size();
+    }
+
+private:
+    const size_t _chunkSize;
+
+    const size_t _maxChunks;
+
+    mutable std::mutex _mutex;
+
+    std::vector<std::unique_ptr<uint8_t[]>> _chunks;
+};
+
+/***
+ * Growable output buffer made of a chain of chunks. Unlike DynamicOutputBuffer it never reallocates and
+ * copies what was already written, so the cost of every write is bounded. The result can be handed to
+ * writev()/sendmsg() as is, or flattened into contiguous memory once.
+ * 
+ * Chunks are taken from (and returned to) a ChunkPool if one is given. Windows larger than a chunk get
+ * a dedicated segment that is never pooled.
+ */
+class SegmentedOutputBuffer final : public OutputBuffer
+{
+public:
+    using OutputBuffer::write;
+
+    explicit SegmentedOutputBuffer(size_t chunkSize = ChunkPool::DEFAULT_CHUNK_SIZE) :
+        _chunkSize(std::max<size_t>(chunkSize, 1)) {}
+
+    explicit SegmentedOutputBuffer(ChunkPool& pool) :
+        _chunkSize(pool.chunkSize()), _pool(&pool) {}
+
+    SegmentedOutputBuffer(const SegmentedOutputBuffer&) = delete;
+
+    SegmentedOutputBuffer& operator=(const SegmentedOutputBuffer&) = delete;
+
+    ~SegmentedOutputBuffer()
+    {
+        clear();
+    }
+
+    std::span<uint8_t> acquire(size_t n) override
+    {
+        if (_segments.empty() || (_segments.back().capacity - _segments.back().size) < n)
+        {
+            addSegment(n);
+        }
+
+        auto& segment = _segments.back();
+        return {segment.data.get() + segment.size, segment.capacity - segment.size};
+    }
+
+    void commit(size_t n) override
+    {
+        _segments.back().size += n;
+        _size += n;
+    }
 
     bool write(uint8_t x) override
     {
-        if (size() >= capacity())
-        {  
-            return false;
+        if (_segments.empty() || _segments.back().size == _segments.back().capacity)
+        {
+            addSegment(1);
         }
 
-        _data[_size++] = x;
+        auto& segment = _segments.back();
+        segment.data[segment.size++] = x;
+        _size++;
 
         return true;
     }
 
-    bool write(std::span<const uint8_t> data, Bytes::Endianess endianness) override
+    size_t size() const override
+    {
+        return _size;
+    }
+
+    /***
+     * Get the written bytes as list of contiguous segments, in order.
+     * 
+     * @return The segments, valid until the buffer is written to or cleared.
+     */
+    std::vector<std::span<const uint8_t>> segments() const
+    {
+        std::vector<std::span<const uint8_t>> out;
+        out.reserve(_segments.size());
+        for (const auto& segment : _segments)
+        {
+            if (segment.size > 0)
+            {
+                out.emplace_back(segment.data.get(), segment.size);
+            }
+        }
+
+        return out;
+    }
+
+#if defined(BORON_HAS_POSIX_IO)
+    /***
+     * Get the written bytes as I/O vectors to be passed to writev() or sendmsg(). Note that the system
+     * limits the number of vectors per call (IOV_MAX).
+     * 
+     * @return The I/O vectors, valid until the buffer is written to or cleared.
+     */
+    std::vector<iovec> iovecs() const
+    {
+        std::vector<iovec> out;
+        out.reserve(_segments.size());
+        for (const auto& segment : _segments)
+        {
+            if (segment.size > 0)
+            {
+                out.push_back({ segment.data.get(), segment.size });
+            }
+        }
+
+        return out;
+    }
+#endif // BORON_HAS_POSIX_IO
+
+    /***
+     * Copy the written bytes into contiguous memory.
+     * 
+     * @param out The destination, must provide at least size() bytes.
+     * 
+     * @return The number of bytes copied, 0 if @p out is too small.
+     */
+    size_t copyTo(std::span<uint8_t> out) const
+    {
+        if (out.size() < _size)
+        {
+            return 0;
+        }
+
+        auto* dst = out.data();
+        for (const auto& segment : _segments)
+        {
+            dst = std::copy(segment.data.get(), segment.data.get() + segment.size, dst);
+        }
+
+        return _size;
+    }
+
+    std::vector<uint8_t> flatten() const
+    {
+        std::vector<uint8_t> out(_size);
+        copyTo(out);
+        return out;
+    }
+
+    /***
+     * Drop all written bytes and return the chunks to the pool.
+     */
+    void clear()
+    {
+        for (auto& segment : _segments)
+        {
+            if (_pool != nullptr && segment.capacity == _chunkSize)
+            {
+                _pool->release(std::move(segment.data));
+            }
+        }
+
+        _segments.clear();
+        _size = 0;
+    }
+
+private:
+    struct Segment
+    {
+        std::unique_ptr<uint8_t[]> data;
+
+        size_t capacity = 0;
+
+        size_t size = 0;
+    };
+
+    void addSegment(size_t n)
+    {
+        if (n > _chunkSize)
+        {
+            _segments.push_back({ std::make_unique_for_overwrite<uint8_t[]>(n), n, 0 });
+        }
+        else if (_pool != nullptr)
+        {
+            _segments.push_back({ _pool->acquire(), _chunkSize, 0 });
+        }
+        else
+        {
+            _segments.push_back({ std::make_unique_for_overwrite<uint8_t[]>(_chunkSize), _chunkSize, 0 });
+        }
+    }
+
+    const size_t _chunkSize;
+
+    ChunkPool* _pool = nullptr;
+
+    std::vector<Segment> _segments;
+
+    size_t _size = 0;
+};
+
+#if defined(BORON_HAS_MMAP)
+/***
+ * Read-only memory mapping of a whole file. The mapping is released when the object is destroyed,
+ * all spans obtained from it must not outlive it.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) :
+        _data(std::exchange(other._data, {})) {}
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile& operator=(MappedFile&& other)
     {
-        if ((size() + data.size()) >= capacity())
+        if (this != &other)
+        {
+            close();
+            _data = std::exchange(other._data, {});
+        }
+
+        return *this;
+    }
+
+    /***
+     * Map the file read-only. The kernel is advised that the mapping will be read sequentially and
+     * soon, so that it reads ahead aggressively.
+     * 
+     * @param path The path of the file.
+     * 
+     * @return True if successful (an empty file yields an empty mapping), false otherwise.
+     */
+    bool open(std::string_view path)
+    {
+        close();
+
+        const int fd = ::open(std::string(path).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        const auto size = (size_t)st.st_size;
+        if (size == 0)
+        {
+            ::close(fd);
+            return true;
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        auto* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (addr == MAP_FAILED)
         {
             return false;
         }
 
-        std::copy(data.begin(), data.end(), _data.begin() + size());
-        if (endianness != Bytes::Endianess::NATIVE)
+        madvise(addr, size, MADV_SEQUENTIAL);
+        madvise(addr, size, MADV_WILLNEED);
+
+        _data = {(const uint8_t*)addr, size};
+
+        return true;
+    }
+
+    void close()
+    {
+        if (_data.empty() == false)
         {
-            std::reverse(_data.begin() + size(), _data.begin() + size() + data.size());
+            munmap(const_cast<uint8_t*>(_data.data()), _data.size());
         }
 
-        _size += data.size();
+        _data = {};
+    }
+
+    std::span<const uint8_t> data() const
+    {
+        return _data;
+    }
+
+    size_t size() const
+    {
+        return _data.size();
+    }
+
+private:
+    std::span<const uint8_t> _data;
+};
+
+/***
+ * Input buffer reading directly from a memory mapped file, decoding from it does not copy the file.
+ */
+class MmapInputBuffer final : public InputBuffer
+{
+public:
+    using InputBuffer::read;
+
+    MmapInputBuffer() = default;
+
+    bool open(std::string_view path)
+    {
+        const auto success = _file.open(path);
+        _buffer = SpanInputBuffer(_file.data());
+        return success;
+    }
+
+    bool read(uint8_t& x) override
+    {
+        return _buffer.read(x);
+    }
+
+    std::span<const uint8_t> readSpan(size_t length) override
+    {
+        return _buffer.readSpan(length);
+    }
+
+    size_t size() const override
+    {
+        return _buffer.size();
+    }
+
+    size_t capacity() const
+    {
+        return _buffer.capacity();
+    }
+
+    std::span<const uint8_t> data() const
+    {
+        return _file.data();
+    }
+
+private:
+    MappedFile _file;
+
+    SpanInputBuffer _buffer{{}};
+};
+#endif // BORON_HAS_MMAP
+
+class SpanOutputBuffer final : public OutputBuffer
+{
+public:
+    using OutputBuffer::write;
+
+    constexpr SpanOutputBuffer() = default;
+
+    constexpr SpanOutputBuffer(std::span<uint8_t> data) :
+        _data(data) {}
+
+    constexpr std::span<uint8_t> acquire(size_t n) override
+    {
+        // a window too small for the request is of no use to the caller
+        if (_data.size() - _size < n)
+        {
+            return {};
+        }
+
+        return _data.subspan(_size);
+    }
+
+    constexpr void commit(size_t n) override
+    {
+        _size += n;
+    }
+
+    bool write(uint8_t x) override
+    {
+        if (size() >= capacity())
+        {  
+            return false;
+        }
+
+        _data[_size++] = x;
 
         return true;
     }
@@ -183,14 +774,37 @@ private:
     size_t _size = 0;
 };
 
-class DynamicOutputBuffer : public OutputBuffer
+class DynamicOutputBuffer final : public OutputBuffer
 {
 public:
+    using OutputBuffer::write;
+
     DynamicOutputBuffer() = default;
 
+    std::span<uint8_t> acquire(size_t n) override
+    {
+        if ((_data.size() - _size) < n)
+        {
+            // grow geometrically so that a sequence of small windows stays amortized O(1)
+            _data.resize(std::max(_size + n, _data.size() * 2));
+        }
+
+        return {_data.data() + _size, _data.size() - _size};
+    }
+
+    void commit(size_t n) override
+    {
+        _size += n;
+    }
+
     bool write(uint8_t x) override
     {
-        _data.push_back(x);
+        if (_size == _data.size())
+        {
+            _data.resize(std::max<size_t>(64, _data.size() * 2));
+        }
+
+        _data[_size++] = x;
         return true;
     }
 
@@ -205,12 +819,261 @@ public:
     }
 
     size_t size() const override
+    {
+        return _size;
+    }
+
+    size_t capacity() const
     {
         return _data.size();
     }
 
+    /***
+     * Drop all written bytes, the capacity is kept.
+     */
+    void clear()
+    {
+        _size = 0;
+    }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > _data.size())
+        {
+            _data.resize(capacity);
+        }
+    }
+
+    /***
+     * Release memory above the given capacity, written bytes are never dropped.
+     * 
+     * @param capacity The capacity to shrink to.
+     */
+    void shrink(size_t capacity)
+    {
+        if (_data.size() > capacity)
+        {
+            _data.resize(std::max(capacity, _size));
+            _data.shrink_to_fit();
+        }
+    }
+
 private:
     std::vector<uint8_t> _data;
+
+    size_t _size = 0;
+};
+
+#if defined(BORON_HAS_POSIX_IO)
+/***
+ * Output buffer streaming to a file descriptor. Output is staged in a fixed-size block that is written
+ * out whenever it is full, so arbitrarily large output needs constant memory. Writes larger than the
+ * free space of the block bypass it and are sent together with the staged bytes in a single writev().
+ * 
+ * Once writing to the descriptor failed, the buffer rejects all further output.
+ */
+class FileOutputBuffer final : public OutputBuffer
+{
+public:
+    using OutputBuffer::write;
+
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+    /***
+     * @param fd The file descriptor, it is not closed by the buffer.
+     * @param blockSize The size of the staging block.
+     */
+    explicit FileOutputBuffer(int fd, size_t blockSize = DEFAULT_BLOCK_SIZE) :
+        _fd(fd), _block(std::max<size_t>(blockSize, 1)), _blockSize(_block.size()) {}
+
+    FileOutputBuffer(const FileOutputBuffer&) = delete;
+
+    FileOutputBuffer& operator=(const FileOutputBuffer&) = delete;
+
+    ~FileOutputBuffer()
+    {
+        flush();
+    }
+
+    std::span<uint8_t> acquire(size_t n) override
+    {
+        // nothing is staged after a failed write, the output would have a gap
+        if (_failed)
+        {
+            return {};
+        }
+
+        if ((_block.size() - _staged) < n)
+        {
+            if (flush() == false)
+            {
+                return {};
+            }
+
+            // windows larger than a block are rare (the encoders write large payloads in pieces), the block
+            // shrinks back on the next flush
+            if (_block.size() < n)
+            {
+                _block.resize(n);
+            }
+        }
+
+        return {_block.data() + _staged, _block.size() - _staged};
+    }
+
+    void commit(size_t n) override
+    {
+        _staged += n;
+    }
+
+    bool write(uint8_t x) override
+    {
+        if (_failed || (_staged == _block.size() && flush() == false))
+        {
+            return false;
+        }
+
+        _block[_staged++] = x;
+        return true;
+    }
+
+    bool write(std::span<const uint8_t> data, Bytes::Endianess endianess = Bytes::Endianess::NATIVE) override
+    {
+        if (endianess != Bytes::Endianess::NATIVE || data.size() < (_block.size() - _staged))
+        {
+            return OutputBuffer::write(data, endianess);
+        }
+
+        if (_failed)
+        {
+            return false;
+        }
+
+        iovec iov[2] = {
+            { _block.data(), _staged },
+            { const_cast<uint8_t*>(data.data()), data.size() }
+        };
+
+        if (writeAll(iov, 2) == false)
+        {
+            return false;
+        }
+
+        _flushed += _staged + data.size();
+        _staged = 0;
+
+        return true;
+    }
+
+    /***
+     * Write all staged bytes to the file descriptor.
+     * 
+     * @return True if successful, false otherwise.
+     */
+    bool flush()
+    {
+        if (_failed)
+        {
+            return false;
+        }
+
+        if (_staged == 0)
+        {
+            return true;
+        }
+
+        iovec iov = { _block.data(), _staged };
+        if (writeAll(&iov, 1) == false)
+        {
+            return false;
+        }
+
+        _flushed += _staged;
+        _staged = 0;
+
+        if (_block.size() > _blockSize)
+        {
+            _block.resize(_blockSize);
+            _block.shrink_to_fit();
+        }
+
+        return true;
+    }
+
+    size_t size() const override
+    {
+        return _flushed + _staged;
+    }
+
+    int fd() const
+    {
+        return _fd;
+    }
+
+    size_t blockSize() const
+    {
+        return _block.size();
+    }
+
+    /***
+     * Check if writing to the file descriptor failed, the buffer rejects all output afterwards.
+     * 
+     * @return True if a write failed, false otherwise.
+     */
+    bool failed() const
+    {
+        return _failed;
+    }
+
+private:
+    bool writeAll(iovec* iov, int count)
+    {
+        while (count > 0)
+        {
+            const auto written = writev(_fd, iov, count);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                _failed = true;
+                return false;
+            }
+
+            // skip the completely written vectors and advance into the partially written one
+            auto remaining = (size_t)written;
+            while (count > 0 && remaining >= iov->iov_len)
+            {
+                remaining -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+
+            if (count > 0)
+            {
+                iov->iov_base = (uint8_t*)iov->iov_base + remaining;
+                iov->iov_len -= remaining;
+            }
+        }
+
+        return true;
+    }
+
+    int _fd = -1;
+
+    std::vector<uint8_t> _block;
+
+    // the size of the block requested at construction
+    size_t _blockSize = 0;
+
+    size_t _staged = 0;
+
+    size_t _flushed = 0;
+
+    bool _failed = false;
 };
+#endif // BORON_HAS_POSIX_IO
 
 #endif // BORON_BUFFERS_H_
\ No newline at end of file
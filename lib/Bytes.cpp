@@ -0,0 +1,146 @@
+#include "Bytes.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+
+#define BORON_HAS_X86_KERNELS 1
+#endif
+
+namespace
+{
+using SwapKernel = void (*)(uint8_t*, const uint8_t*, size_t, size_t);
+
+template <typename T>
+void swapScalar(uint8_t* dst, const uint8_t* src, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        Bytes::store<T>(dst + i * sizeof(T), Bytes::byteswap(Bytes::load<T>(src + i * sizeof(T))));
+    }
+}
+
+void swapScalar(uint8_t* dst, const uint8_t* src, size_t count, size_t width)
+{
+    switch (width)
+    {
+        case sizeof(uint16_t):
+        {
+            swapScalar<uint16_t>(dst, src, count);
+            break;
+        }
+        case sizeof(uint32_t):
+        {
+            swapScalar<uint32_t>(dst, src, count);
+            break;
+        }
+        case sizeof(uint64_t):
+        {
+            swapScalar<uint64_t>(dst, src, count);
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+#ifdef BORON_HAS_X86_KERNELS
+// byte shuffles reversing every 2, 4 and 8 byte group of a 16 byte lane
+alignas(16) constexpr uint8_t SHUFFLE_16[16] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+alignas(16) constexpr uint8_t SHUFFLE_32[16] = { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+alignas(16) constexpr uint8_t SHUFFLE_64[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+const uint8_t* shuffleMask(size_t width)
+{
+    switch (width)
+    {
+        case sizeof(uint16_t):
+        {
+            return SHUFFLE_16;
+        }
+        case sizeof(uint32_t):
+        {
+            return SHUFFLE_32;
+        }
+        default:
+        {
+            return SHUFFLE_64;
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+void swapSsse3(uint8_t* dst, const uint8_t* src, size_t count, size_t width)
+{
+    const auto mask = _mm_load_si128((const __m128i*)shuffleMask(width));
+    const auto bytes = count * width;
+
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16)
+    {
+        const auto x = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(x, mask));
+    }
+
+    swapScalar(dst + i, src + i, (bytes - i) / width, width);
+}
+
+__attribute__((target("avx2")))
+void swapAvx2(uint8_t* dst, const uint8_t* src, size_t count, size_t width)
+{
+    // vpshufb shuffles within each 128 bit lane, so both lanes use the same mask
+    const auto mask = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)shuffleMask(width)));
+    const auto bytes = count * width;
+
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64)
+    {
+        const auto x0 = _mm256_loadu_si256((const __m256i*)(src + i));
+        const auto x1 = _mm256_loadu_si256((const __m256i*)(src + i + 32));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(x0, mask));
+        _mm256_storeu_si256((__m256i*)(dst + i + 32), _mm256_shuffle_epi8(x1, mask));
+    }
+
+    for (; i + 32 <= bytes; i += 32)
+    {
+        const auto x = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(x, mask));
+    }
+
+    swapScalar(dst + i, src + i, (bytes - i) / width, width);
+}
+#endif // BORON_HAS_X86_KERNELS
+
+SwapKernel selectKernel()
+{
+#ifdef BORON_HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return swapAvx2;
+    }
+    else if (__builtin_cpu_supports("ssse3"))
+    {
+        return swapSsse3;
+    }
+#endif // BORON_HAS_X86_KERNELS
+
+    return swapScalar;
+}
+} // namespace
+
+void Bytes::swapBytes(uint8_t* dst, const uint8_t* src, size_t count, size_t width)
+{
+    static const SwapKernel kernel = selectKernel();
+
+    // values shorter than a vector are not worth the indirect call
+    if (count * width < 16)
+    {
+        swapScalar(dst, src, count, width);
+    }
+    else
+    {
+        kernel(dst, src, count, width);
+    }
+}
\ No newline at end of file
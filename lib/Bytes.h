@@ -3,10 +3,16 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #if __cplusplus >= 202000L
 #include <span>
@@ -27,53 +33,209 @@ enum class Endianess
     LITTLE,
     BIG,
     NETWORK = BIG,
-    #if BYTE_ORDER == LITTLE_ENDIAN
-    NATIVE = LITTLE
-    #else
-    NATIVE = BIG
-    #endif // BYTE_ORDER == LITTLE_ENDIAN
+    NATIVE = std::endian::native == std::endian::little ? LITTLE : BIG
 };
 
-template <typename T, size_t N = sizeof(T)>
-    requires(std::is_fundamental_v<T>)
-inline std::array<uint8_t, N> getBytes(const T& x, Endianess endianess = Endianess::NATIVE)
+namespace Detail
+{
+template <size_t N>
+struct UnsignedOfSize;
+
+template <>
+struct UnsignedOfSize<1> { using type = uint8_t; };
+
+template <>
+struct UnsignedOfSize<2> { using type = uint16_t; };
+
+template <>
+struct UnsignedOfSize<4> { using type = uint32_t; };
+
+template <>
+struct UnsignedOfSize<8> { using type = uint64_t; };
+} // namespace Detail
+
+/***
+ * Types whose byte order can be converted, i.e. integers and floating point numbers of 1, 2, 4 or 8 bytes.
+ */
+template <typename T>
+concept Swappable = std::is_arithmetic_v<T> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+/***
+ * Reverse the byte order of a value.
+ * 
+ * @param x The value.
+ * 
+ * @return The value with its bytes in reverse order.
+ */
+template <Swappable T>
+constexpr T byteswap(T x)
 {
-    union
+    using U = typename Detail::UnsignedOfSize<sizeof(T)>::type;
+
+    if constexpr (sizeof(T) == 1)
+    {
+        return x;
+    }
+    else if constexpr (sizeof(T) == 2)
+    {
+        return std::bit_cast<T>((U)__builtin_bswap16(std::bit_cast<U>(x)));
+    }
+    else if constexpr (sizeof(T) == 4)
     {
-        T x;
+        return std::bit_cast<T>((U)__builtin_bswap32(std::bit_cast<U>(x)));
+    }
+    else
+    {
+        return std::bit_cast<T>((U)__builtin_bswap64(std::bit_cast<U>(x)));
+    }
+}
 
-        std::array<uint8_t, N> bytes;
-    } cvt;
-    
-    cvt.x = x;
+/***
+ * Convert a value between native byte order and @p endianess. The conversion is its own inverse.
+ * 
+ * @param x The value.
+ * @param endianess The foreign byte order.
+ * 
+ * @return The converted value.
+ */
+template <Swappable T>
+constexpr T convert(T x, Endianess endianess)
+{
+    return endianess == Endianess::NATIVE ? x : byteswap(x);
+}
 
-    if (endianess != Endianess::NATIVE)
+/***
+ * Load a value stored in @p endianess from (possibly unaligned) memory.
+ * 
+ * @param bytes Pointer to at least sizeof(T) bytes.
+ * @param endianess The byte order of the stored value.
+ * 
+ * @return The value in native byte order.
+ */
+template <Swappable T>
+inline T load(const uint8_t* bytes, Endianess endianess = Endianess::NATIVE)
+{
+    T x;
+    memcpy(&x, bytes, sizeof(T));
+    return convert(x, endianess);
+}
+
+/***
+ * Store a value in @p endianess to (possibly unaligned) memory.
+ * 
+ * @param bytes Pointer to at least sizeof(T) writable bytes.
+ * @param x The value in native byte order.
+ * @param endianess The byte order to store the value in.
+ */
+template <Swappable T>
+inline void store(uint8_t* bytes, T x, Endianess endianess = Endianess::NATIVE)
+{
+    x = convert(x, endianess);
+    memcpy(bytes, &x, sizeof(T));
+}
+
+/***
+ * Reverse the byte order of @p count values of @p width bytes each, reading from @p src and writing
+ * to @p dst (which may be equal to @p src). Uses SSSE3 or AVX2 shuffle kernels if the CPU supports them.
+ * 
+ * @param dst Destination of count * width bytes.
+ * @param src Source of count * width bytes.
+ * @param count The number of values.
+ * @param width The size of a value, must be 2, 4 or 8.
+ */
+void swapBytes(uint8_t* dst, const uint8_t* src, size_t count, size_t width);
+
+/***
+ * Convert a span of values in place between native byte order and @p endianess.
+ * 
+ * @param values The values.
+ * @param endianess The foreign byte order.
+ */
+template <Swappable T>
+inline void convert(std::span<T> values, Endianess endianess)
+{
+    if (sizeof(T) > 1 && endianess != Endianess::NATIVE)
+    {
+        swapBytes((uint8_t*)values.data(), (const uint8_t*)values.data(), values.size(), sizeof(T));
+    }
+}
+
+/***
+ * Load an array of values stored in @p endianess.
+ * 
+ * @param bytes The stored values.
+ * @param values The destination in native byte order.
+ * @param endianess The byte order of the stored values.
+ * 
+ * @return The number of values loaded, the minimum of both spans.
+ */
+template <Swappable T>
+inline size_t load(std::span<const uint8_t> bytes, std::span<T> values, Endianess endianess = Endianess::NATIVE)
+{
+    const auto count = std::min(bytes.size() / sizeof(T), values.size());
+    if (sizeof(T) > 1 && endianess != Endianess::NATIVE)
+    {
+        swapBytes((uint8_t*)values.data(), bytes.data(), count, sizeof(T));
+    }
+    else if (count > 0)
     {
-        std::reverse(cvt.bytes.begin(), cvt.bytes.end());
+        memcpy(values.data(), bytes.data(), count * sizeof(T));
     }
 
-    return cvt.bytes;
+    return count;
 }
 
-template <typename T, size_t N = sizeof(T)>
-    requires(sizeof(T) >= N)
-inline T fromBytes(std::span<const uint8_t> bytes, Endianess endianess = Endianess::NATIVE)
+/***
+ * Store an array of values in @p endianess.
+ * 
+ * @param values The values in native byte order.
+ * @param bytes The destination.
+ * @param endianess The byte order to store the values in.
+ * 
+ * @return The number of values stored, the minimum of both spans.
+ */
+template <Swappable T>
+inline size_t store(std::span<const T> values, std::span<uint8_t> bytes, Endianess endianess = Endianess::NATIVE)
 {
-    union 
+    const auto count = std::min(bytes.size() / sizeof(T), values.size());
+    if (sizeof(T) > 1 && endianess != Endianess::NATIVE)
     {
-        T x;
+        swapBytes(bytes.data(), (const uint8_t*)values.data(), count, sizeof(T));
+    }
+    else if (count > 0)
+    {
+        memcpy(bytes.data(), values.data(), count * sizeof(T));
+    }
 
-        std::array<uint8_t, N> bytes;
-    } cvt;
+    return count;
+}
 
-    std::copy(bytes.begin(), bytes.end(), cvt.bytes.begin());
+template <Swappable T>
+constexpr std::array<uint8_t, sizeof(T)> getBytes(const T& x, Endianess endianess = Endianess::NATIVE)
+{
+    return std::bit_cast<std::array<uint8_t, sizeof(T)>>(convert(x, endianess));
+}
 
-    if (endianess != Endianess::NATIVE)
+template <Swappable T>
+inline T fromBytes(std::span<const uint8_t> bytes, Endianess endianess = Endianess::NATIVE)
+{
+    if (bytes.size() < sizeof(T))
     {
-        std::reverse(cvt.bytes.begin(), cvt.bytes.end());
+        // the missing high-order bytes are zero
+        std::array<uint8_t, sizeof(T)> padded{};
+        if (endianess == Endianess::BIG)
+        {
+            std::copy(bytes.begin(), bytes.end(), padded.end() - bytes.size());
+        }
+        else
+        {
+            std::copy(bytes.begin(), bytes.end(), padded.begin());
+        }
+
+        return load<T>(padded.data(), endianess);
     }
 
-    return cvt.x;
+    return load<T>(bytes.data(), endianess);
 }
 
 template <typename T>
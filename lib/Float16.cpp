@@ -0,0 +1,136 @@
+#include "Float16.h"
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+
+#define BORON_HAS_X86_KERNELS 1
+#endif
+
+namespace
+{
+using ToFloatKernel = void (*)(const uint16_t*, float*, size_t);
+
+using FromFloatKernel = void (*)(const float*, uint16_t*, size_t);
+
+void toFloatPortable(const uint16_t* halfs, float* values, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        values[i] = Float16::Detail::toFloat(halfs[i]);
+    }
+}
+
+void fromFloatPortable(const float* values, uint16_t* halfs, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        halfs[i] = Float16::Detail::fromFloat(values[i]);
+    }
+}
+
+#ifdef BORON_HAS_X86_KERNELS
+__attribute__((target("avx,f16c")))
+void toFloatF16c(const uint16_t* halfs, float* values, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto x = _mm_loadu_si128((const __m128i*)(halfs + i));
+        _mm256_storeu_ps(values + i, _mm256_cvtph_ps(x));
+    }
+
+    for (; i < count; ++i)
+    {
+        values[i] = _cvtsh_ss(halfs[i]);
+    }
+}
+
+__attribute__((target("avx,f16c")))
+void fromFloatF16c(const float* values, uint16_t* halfs, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto x = _mm256_loadu_ps(values + i);
+        _mm_storeu_si128((__m128i*)(halfs + i), _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    for (; i < count; ++i)
+    {
+        halfs[i] = _cvtss_sh(values[i], _MM_FROUND_TO_NEAREST_INT);
+    }
+}
+
+bool hasF16c()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+}
+#endif // BORON_HAS_X86_KERNELS
+
+ToFloatKernel selectToFloat()
+{
+#ifdef BORON_HAS_X86_KERNELS
+    if (hasF16c())
+    {
+        return toFloatF16c;
+    }
+#endif // BORON_HAS_X86_KERNELS
+
+    return toFloatPortable;
+}
+
+FromFloatKernel selectFromFloat()
+{
+#ifdef BORON_HAS_X86_KERNELS
+    if (hasF16c())
+    {
+        return fromFloatF16c;
+    }
+#endif // BORON_HAS_X86_KERNELS
+
+    return fromFloatPortable;
+}
+
+ToFloatKernel toFloatKernel()
+{
+    static const ToFloatKernel kernel = selectToFloat();
+    return kernel;
+}
+
+FromFloatKernel fromFloatKernel()
+{
+    static const FromFloatKernel kernel = selectFromFloat();
+    return kernel;
+}
+} // namespace
+
+float Float16::toFloat(uint16_t half)
+{
+    float value;
+    toFloatKernel()(&half, &value, 1);
+    return value;
+}
+
+uint16_t Float16::fromFloat(float value)
+{
+    uint16_t half;
+    fromFloatKernel()(&value, &half, 1);
+    return half;
+}
+
+size_t Float16::toFloat(std::span<const uint16_t> halfs, std::span<float> values)
+{
+    const auto count = std::min(halfs.size(), values.size());
+    toFloatKernel()(halfs.data(), values.data(), count);
+    return count;
+}
+
+size_t Float16::fromFloat(std::span<const float> values, std::span<uint16_t> halfs)
+{
+    const auto count = std::min(halfs.size(), values.size());
+    fromFloatKernel()(values.data(), halfs.data(), count);
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef BORON_FLOAT16_H_
+#define BORON_FLOAT16_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <bit>
+#include <span>
+
+/***
+ * Conversion between IEEE 754 half-precision floats (stored as their bit pattern in a uint16_t) and
+ * single-precision floats. Uses the F16C instructions if the CPU supports them.
+ */
+namespace Float16
+{
+namespace Detail
+{
+/***
+ * Portable conversion from half to single precision, exact for all values but signaling NaNs.
+ */
+constexpr float toFloat(uint16_t half)
+{
+    const uint32_t sign = uint32_t(half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1f;
+    const uint32_t mantissa = half & 0x3ff;
+
+    if (exponent == 0x1f)
+    {
+        // infinity and NaN, NaNs are quieted like F16C does
+        return std::bit_cast<float>(sign | 0x7f800000 | (mantissa != 0 ? 0x400000 : 0) | (mantissa << 13));
+    }
+    else if (exponent == 0)
+    {
+        // zero and subnormals are multiples of 2^-24
+        const auto value = (float)mantissa * 0x1p-24f;
+        return sign != 0 ? -value : value;
+    }
+
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+/***
+ * Portable conversion from single to half precision, rounding to nearest even like F16C.
+ */
+constexpr uint16_t fromFloat(float value)
+{
+    const auto x = std::bit_cast<uint32_t>(value);
+    const auto sign = uint16_t((x >> 16) & 0x8000);
+    const auto abs = x & 0x7fffffff;
+
+    if (abs >= 0x7f800000)
+    {
+        // infinity and NaN, NaNs are quieted
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 | ((abs >> 13) & 0x3ff) : 0);
+    }
+    else if (abs >= 0x477ff000)
+    {
+        // 65520 and above round to infinity
+        return sign | 0x7c00;
+    }
+    else if (abs < 0x38800000)
+    {
+        // below 2^-14 the result is subnormal, below 2^-25 it is zero
+        if (abs < 0x33000000)
+        {
+            return sign;
+        }
+
+        const uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+        const uint32_t shift = 126 - (abs >> 23);
+        const uint32_t remainder = mantissa & ((uint32_t(1) << shift) - 1);
+        const uint32_t halfway = uint32_t(1) << (shift - 1);
+
+        uint32_t result = mantissa >> shift;
+        if (remainder > halfway || (remainder == halfway && (result & 1) != 0))
+        {
+            result++;
+        }
+
+        return sign | (uint16_t)result;
+    }
+
+    // rebias the exponent from 127 to 15, a carry out of the mantissa increments the exponent
+    const uint32_t rebiased = abs - 0x38000000;
+    const uint32_t remainder = rebiased & 0x1fff;
+
+    uint32_t result = rebiased >> 13;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1) != 0))
+    {
+        result++;
+    }
+
+    return sign | (uint16_t)result;
+}
+} // namespace Detail
+
+/***
+ * Convert a half-precision float to single precision.
+ * 
+ * @param half The bit pattern of the half-precision float.
+ * 
+ * @return The value, every half-precision value is exactly representable.
+ */
+float toFloat(uint16_t half);
+
+/***
+ * Convert a single-precision float to half precision, rounding to nearest even.
+ * 
+ * @param value The value.
+ * 
+ * @return The bit pattern of the half-precision float.
+ */
+uint16_t fromFloat(float value);
+
+/***
+ * Convert a span of half-precision floats to single precision.
+ * 
+ * @return The number of values converted, the minimum of both sizes.
+ */
+size_t toFloat(std::span<const uint16_t> halfs, std::span<float> values);
+
+/***
+ * Convert a span of single-precision floats to half precision.
+ * 
+ * @return The number of values converted, the minimum of both sizes.
+ */
+size_t fromFloat(std::span<const float> values, std::span<uint16_t> halfs);
+} // namespace Float16
+
+#endif // BORON_FLOAT16_H_
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "Utf8.h"
+
+#include <cstring>
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+
+#define BORON_HAS_X86_KERNELS 1
+#endif
+
+namespace
+{
+using Kernel = bool (*)(const uint8_t*, size_t);
+
+constexpr uint64_t ASCII_MASK = UINT64_C(0x8080808080808080);
+
+bool validatePortable(const uint8_t* bytes, size_t size)
+{
+    size_t i = 0;
+    while (i < size)
+    {
+        // runs of ASCII are skipped a word at a time
+        if (i + sizeof(uint64_t) <= size)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            if ((word & ASCII_MASK) == 0)
+            {
+                i += sizeof(uint64_t);
+                continue;
+            }
+        }
+
+        const auto length = Utf8::Detail::sequenceLength(bytes + i, size - i);
+        if (length == 0)
+        {
+            return false;
+        }
+
+        i += length;
+    }
+
+    return true;
+}
+
+/***
+ * Get the length of the sequence that starts with the lead byte @p x (at least 0xc0), valid or not.
+ */
+constexpr size_t sequenceLength(uint8_t x)
+{
+    return x < 0xe0 ? 2 : (x < 0xf0 ? 3 : 4);
+}
+
+/***
+ * Get the start of the sequence that is cut off by @p end, @p end if no sequence is.
+ */
+size_t sequenceStart(const uint8_t* bytes, size_t end)
+{
+    for (size_t back = 1; back <= 3 && back <= end; ++back)
+    {
+        const auto x = bytes[end - back];
+        if (x < 0x80)
+        {
+            break;
+        }
+        else if (x >= 0xc0)
+        {
+            return sequenceLength(x) > back ? end - back : end;
+        }
+    }
+
+    return end;
+}
+
+#ifdef BORON_HAS_X86_KERNELS
+// the lookup algorithm of Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte":
+// every error of a two byte window is a bit that is set in all three tables indexed by its nibbles
+constexpr uint8_t TOO_SHORT = 1 << 0; // a lead byte not followed by a continuation byte
+constexpr uint8_t TOO_LONG = 1 << 1; // a continuation byte after ASCII
+constexpr uint8_t OVERLONG_3 = 1 << 2; // 0xe0 0x80..0x9f
+constexpr uint8_t TOO_LARGE = 1 << 3; // above U+10FFFF
+constexpr uint8_t SURROGATE = 1 << 4; // 0xed 0xa0..0xbf
+constexpr uint8_t OVERLONG_2 = 1 << 5; // 0xc0 and 0xc1
+constexpr uint8_t TOO_LARGE_1000 = 1 << 6; // above U+10FFFF with a second byte 0x80..0x8f
+constexpr uint8_t OVERLONG_4 = 1 << 6; // 0xf0 0x80..0x8f
+constexpr uint8_t TWO_CONTS = 1 << 7; // two continuation bytes, valid only within a longer sequence
+constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+alignas(16) constexpr uint8_t BYTE_1_HIGH[16] = {
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+};
+
+alignas(16) constexpr uint8_t BYTE_1_LOW[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    CARRY | OVERLONG_2,
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000
+};
+
+alignas(16) constexpr uint8_t BYTE_2_HIGH[16] = {
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+};
+
+// a block ending in a lead byte of a longer sequence than fits is incomplete
+alignas(32) constexpr uint8_t INCOMPLETE_MAX[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1
+};
+
+__attribute__((target("avx2")))
+__m256i lookup(const uint8_t (&table)[16], __m256i nibbles)
+{
+    const auto x = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)table));
+    return _mm256_shuffle_epi8(x, nibbles);
+}
+
+__attribute__((target("avx2")))
+bool validateAvx2(const uint8_t* bytes, size_t size)
+{
+    const auto zero = _mm256_setzero_si256();
+    const auto low = _mm256_set1_epi8(0x0f);
+    const auto incompleteMax = _mm256_load_si256((const __m256i*)INCOMPLETE_MAX);
+
+    auto error = zero;
+    auto previous = zero;
+    auto previousIncomplete = zero;
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const auto input = _mm256_loadu_si256((const __m256i*)(bytes + i));
+        if (_mm256_movemask_epi8(input) == 0)
+        {
+            // ASCII only continues complete sequences
+            error = _mm256_or_si256(error, previousIncomplete);
+            previousIncomplete = zero;
+            previous = input;
+            continue;
+        }
+
+        // the input shifted by one to three bytes, filled with the end of the previous block
+        const auto carried = _mm256_permute2x128_si256(previous, input, 0x21);
+        const auto prev1 = _mm256_alignr_epi8(input, carried, 15);
+        const auto prev2 = _mm256_alignr_epi8(input, carried, 14);
+        const auto prev3 = _mm256_alignr_epi8(input, carried, 13);
+
+        const auto byte1High = lookup(BYTE_1_HIGH, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low));
+        const auto byte1Low = lookup(BYTE_1_LOW, _mm256_and_si256(prev1, low));
+        const auto byte2High = lookup(BYTE_2_HIGH, _mm256_and_si256(_mm256_srli_epi16(input, 4), low));
+        const auto special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+        // the third and fourth byte of a sequence must be continuation bytes, only those may have TWO_CONTS set
+        const auto third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xe0 - 0x80)));
+        const auto fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xf0 - 0x80)));
+        const auto must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+
+        error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+        previousIncomplete = _mm256_subs_epu8(input, incompleteMax);
+        previous = input;
+    }
+
+    if (_mm256_testz_si256(error, error) == 0)
+    {
+        return false;
+    }
+
+    // a sequence cut off by the last block is checked again with the remaining bytes
+    const auto start = sequenceStart(bytes, i);
+    return validatePortable(bytes + start, size - start);
+}
+
+bool hasAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif // BORON_HAS_X86_KERNELS
+
+Kernel selectKernel()
+{
+#ifdef BORON_HAS_X86_KERNELS
+    if (hasAvx2())
+    {
+        return validateAvx2;
+    }
+#endif // BORON_HAS_X86_KERNELS
+
+    return validatePortable;
+}
+
+Kernel kernel()
+{
+    static const Kernel kernel = selectKernel();
+    return kernel;
+}
+} // namespace
+
+bool Utf8::validate(std::span<const uint8_t> bytes)
+{
+    return kernel()(bytes.data(), bytes.size());
+}
+
+bool Utf8::validate(std::span<const char> text)
+{
+    return kernel()((const uint8_t*)text.data(), text.size());
+}
+
+bool Utf8::Validator::feed(std::span<const uint8_t> bytes)
+{
+    // the sequence cut off by the previous part is completed first
+    if (_size > 0)
+    {
+        const auto length = sequenceLength(_tail[0]);
+        const auto n = std::min(length - _size, bytes.size());
+        std::memcpy(_tail + _size, bytes.data(), n);
+        _size += n;
+        bytes = bytes.subspan(n);
+
+        if (_size < length)
+        {
+            return true;
+        }
+        else if (Detail::sequenceLength(_tail, _size) != length)
+        {
+            return false;
+        }
+
+        _size = 0;
+    }
+
+    const auto end = sequenceStart(bytes.data(), bytes.size());
+    std::memcpy(_tail, bytes.data() + end, bytes.size() - end);
+    _size = bytes.size() - end;
+
+    return kernel()(bytes.data(), end);
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#ifndef BORON_UTF8_H_
+#define BORON_UTF8_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+
+/***
+ * Validation of UTF-8 as required for CBOR text strings (RFC 3629: no overlong encodings, no surrogates,
+ * no code points above U+10FFFF). Uses AVX2 if the CPU supports it.
+ */
+namespace Utf8
+{
+namespace Detail
+{
+/***
+ * Get the length of the valid UTF-8 sequence at @p bytes.
+ * 
+ * @param bytes The sequence.
+ * @param size The number of bytes readable at @p bytes, at least 1.
+ * 
+ * @return The length of the sequence, 0 if it is invalid or incomplete.
+ */
+constexpr size_t sequenceLength(const uint8_t* bytes, size_t size)
+{
+    const auto lead = bytes[0];
+    if (lead < 0x80)
+    {
+        return 1;
+    }
+
+    // the range of the second byte excludes overlong encodings, surrogates and code points above U+10FFFF
+    size_t length = 0;
+    uint8_t low = 0x80;
+    uint8_t high = 0xbf;
+    if (lead < 0xc2)
+    {
+        return 0;
+    }
+    else if (lead < 0xe0)
+    {
+        length = 2;
+    }
+    else if (lead < 0xf0)
+    {
+        length = 3;
+        low = lead == 0xe0 ? 0xa0 : 0x80;
+        high = lead == 0xed ? 0x9f : 0xbf;
+    }
+    else if (lead < 0xf5)
+    {
+        length = 4;
+        low = lead == 0xf0 ? 0x90 : 0x80;
+        high = lead == 0xf4 ? 0x8f : 0xbf;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (size < length || bytes[1] < low || bytes[1] > high)
+    {
+        return 0;
+    }
+
+    for (size_t i = 2; i < length; ++i)
+    {
+        if ((bytes[i] & 0xc0) != 0x80)
+        {
+            return 0;
+        }
+    }
+
+    return length;
+}
+
+/***
+ * Portable validation, one sequence at a time.
+ */
+constexpr bool validate(std::span<const uint8_t> bytes)
+{
+    for (size_t i = 0; i < bytes.size(); )
+    {
+        const auto length = sequenceLength(bytes.data() + i, bytes.size() - i);
+        if (length == 0)
+        {
+            return false;
+        }
+
+        i += length;
+    }
+
+    return true;
+}
+} // namespace Detail
+
+/***
+ * Check if @p bytes are valid UTF-8.
+ * 
+ * @param bytes The bytes.
+ * 
+ * @return True if they are valid, false otherwise.
+ */
+bool validate(std::span<const uint8_t> bytes);
+
+bool validate(std::span<const char> text);
+
+/***
+ * Validation of UTF-8 that arrives in parts, a sequence may be split between two parts.
+ */
+class Validator
+{
+public:
+    /***
+     * Validate the next part.
+     * 
+     * @param bytes The part.
+     * 
+     * @return True if the bytes so far are valid, but for a sequence cut off by the end of @p bytes.
+     */
+    bool feed(std::span<const uint8_t> bytes);
+
+    /***
+     * Check if no sequence is cut off, i.e. if the bytes so far are valid UTF-8 if feed() succeeded.
+     */
+    constexpr bool complete() const
+    {
+        return _size == 0;
+    }
+
+    constexpr void reset()
+    {
+        _size = 0;
+    }
+
+private:
+    // the start of the sequence cut off by the last part
+    uint8_t _tail[4] = {};
+
+    size_t _size = 0;
+};
+} // namespace Utf8
+
+#endif // BORON_UTF8_H_
\ No newline at end of file
@@ -8,11 +8,21 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <numeric>
 
 #include "Types.h"
 
 namespace CBOR
 {
+/***
+ * How the memory of the previous allocations is treated by AllocatorBase::reset().
+ */
+enum class ResetPolicy : uint8_t
+{
+    KEEP, /**< keep all memory for the next allocations */
+    SHRINK /**< keep as much memory as the most allocations since the last shrink took, release the rest */
+};
+
 class AllocatorBase
 {
 public:
@@ -34,7 +44,152 @@ public:
      * @return The capacity.
      */
     virtual size_t capacity() const = 0;
+
+    /***
+     * Make sure that @p n more items (or bytes) can be allocated. Dynamic allocators allocate them at once.
+     * 
+     * @param n The number of items or bytes.
+     * 
+     * @return True if they can be allocated, false if they exceed the capacity of a static allocator.
+     */
+    virtual bool reserve(size_t n) = 0;
+
+    /***
+     * Clear all allocations but keep the memory for the next ones. Allocators without memory of their own
+     * just clear.
+     * 
+     * @param policy How much memory is kept.
+     */
+    virtual void reset(ResetPolicy)
+    {
+        clear();
+    }
+};
+
+namespace Detail
+{
+/***
+ * Slabs of growing size whose elements are handed out in order. The slabs are kept across reset(), so that
+ * allocations of similar size need no more memory after the first.
+ */
+template <typename T, size_t MIN_SLAB_SIZE, size_t MAX_SLAB_SIZE>
+class SlabPool
+{
+public:
+    /***
+     * Take @p n consecutive elements.
+     */
+    T* take(size_t n)
+    {
+        if (_slabs.empty() || n > _slabs[_current].size - _used)
+        {
+            next(n, std::max(n, std::clamp(_slabs.empty() ? 0 : _slabs.back().size * 2, MIN_SLAB_SIZE, MAX_SLAB_SIZE)));
+        }
+
+        auto* elements = _slabs[_current].data.get() + _used;
+        _used += n;
+        _size += n;
+        _highWater = std::max(_highWater, _size);
+        return elements;
+    }
+
+    /***
+     * Make sure that the next @p n elements are taken from a single slab.
+     */
+    void reserve(size_t n)
+    {
+        if (_slabs.empty() || n > _slabs[_current].size - _used)
+        {
+            next(n, n);
+        }
+    }
+
+    /***
+     * Get the number of elements taken.
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /***
+     * Get the number of elements of all slabs.
+     */
+    size_t retained() const
+    {
+        return std::accumulate(_slabs.begin(), _slabs.end(), size_t(0), [](size_t sum, const Slab& slab) { return sum + slab.size; });
+    }
+
+    void clear()
+    {
+        _slabs.clear();
+        _current = 0;
+        _used = 0;
+        _size = 0;
+        _highWater = 0;
+    }
+
+    void reset(ResetPolicy policy)
+    {
+        if (policy == ResetPolicy::SHRINK)
+        {
+            // the first slabs are kept as long as they are needed for the most elements taken
+            size_t kept = 0;
+            for (size_t capacity = 0; kept < _slabs.size() && capacity < _highWater; ++kept)
+            {
+                capacity += _slabs[kept].size;
+            }
+
+            _slabs.resize(kept);
+            _highWater = 0;
+        }
+
+        _current = 0;
+        _used = 0;
+        _size = 0;
+    }
+
+private:
+    struct Slab
+    {
+        std::unique_ptr<T[]> data;
+
+        size_t size = 0;
+    };
+
+    /***
+     * Continue with the next kept slab that has room for @p n elements, or a new one of @p size elements.
+     * Kept slabs that are too small are left for the next reset().
+     */
+    void next(size_t n, size_t size)
+    {
+        for (auto i = _slabs.empty() ? 0 : _current + 1; i < _slabs.size(); ++i)
+        {
+            if (_slabs[i].size >= n)
+            {
+                _current = i;
+                _used = 0;
+                return;
+            }
+        }
+
+        _slabs.push_back(Slab{ std::make_unique_for_overwrite<T[]>(size), size });
+        _current = _slabs.size() - 1;
+        _used = 0;
+    }
+
+    std::vector<Slab> _slabs;
+
+    size_t _current = 0;
+
+    size_t _used = 0;
+
+    size_t _size = 0;
+
+    // most elements taken since the last shrink
+    size_t _highWater = 0;
 };
+} // namespace Detail
 
 class ItemAllocator : public AllocatorBase
 {
@@ -85,6 +240,11 @@ public:
         return N;
     }
 
+    constexpr bool reserve(size_t n) override
+    {
+        return n <= capacity() - size();
+    }
+
     item_t* allocate() override
     {
         if (size() >= capacity())
@@ -92,6 +252,8 @@ public:
             return nullptr;
         }
 
+        // the items of a previous message are still there
+        _items[_size] = item_t();
         return &_items[_size++];
     }
 
@@ -102,7 +264,8 @@ private:
 };
 
 /***
- * Allocates items on the heap.
+ * Allocates items on the heap in slabs of growing size, reserve() allocates a single slab of the
+ * requested size. reset() keeps the slabs for the items of the next message.
  */
 class DynamicItemAllocator : public ItemAllocator
 {
@@ -111,12 +274,17 @@ public:
 
     void clear() override
     {
-        _items.clear();
+        _slabs.clear();
+    }
+
+    void reset(ResetPolicy policy) override
+    {
+        _slabs.reset(policy);
     }
 
     size_t size() const override
     {
-        return _items.size();
+        return _slabs.size();
     }
 
     constexpr size_t capacity() const override
@@ -124,14 +292,30 @@ public:
         return 0;
     }
 
+    bool reserve(size_t n) override
+    {
+        _slabs.reserve(n);
+        return true;
+    }
+
     item_t* allocate() override
     {
-       auto& item = _items.emplace_back(std::make_unique<item_t>());
-       return item.get();
+        // kept slabs hold the items of a previous message
+        auto* item = _slabs.take(1);
+        *item = item_t();
+        return item;
+    }
+
+    /***
+     * Get the number of items the allocator holds memory for.
+     */
+    size_t retained() const
+    {
+        return _slabs.retained();
     }
 
 private:
-    std::vector<std::unique_ptr<item_t>> _items;
+    Detail::SlabPool<item_t, 64, 65536> _slabs;
 };
 
 /***
@@ -157,6 +341,11 @@ public:
         return 0;
     }
 
+    constexpr bool reserve(size_t) override
+    {
+        return true;
+    }
+
     constexpr uint8_t* allocate(size_t n, std::span<const uint8_t> init) override
     {
         return const_cast<uint8_t*>(init.data());
@@ -190,9 +379,14 @@ public:
         return N;
     }
 
+    constexpr bool reserve(size_t n) override
+    {
+        return n <= capacity() - size();
+    }
+
     uint8_t* allocate(size_t n, std::span<const uint8_t> init) override
     {
-        if (size() + n >= capacity())
+        if (n > capacity() - size())
         {
             return nullptr;
         }
@@ -214,6 +408,10 @@ private:
     size_t _size = 0;
 };
 
+/***
+ * Allocates bytes on the heap in slabs of growing size, reserve() allocates a single slab of the
+ * requested size. reset() keeps the slabs for the strings of the next message.
+ */
 class DynamicBlobAllocator : public BlobAllocator
 {
 public:
@@ -221,15 +419,17 @@ public:
 
     void clear() override
     {
-        _blobs.clear();
+        _slabs.clear();
+    }
+
+    void reset(ResetPolicy policy) override
+    {
+        _slabs.reset(policy);
     }
 
     size_t size() const override
     {
-        return std::reduce(_blobs.begin(), _blobs.end(), 0, [](size_t init, const auto& blob) -> size_t
-        {
-            return init + blob.second;
-        });
+        return _slabs.size();
     }
 
     constexpr size_t capacity() const override
@@ -237,21 +437,33 @@ public:
         return 0;
     }
 
-    uint8_t* allocate(size_t n, std::span<const uint8_t> init) override
+    bool reserve(size_t n) override
     {
-        auto ptr = std::make_unique<uint8_t[]>(n);
+        _slabs.reserve(n);
+        return true;
+    }
 
+    uint8_t* allocate(size_t n, std::span<const uint8_t> init) override
+    {
+        auto* blob = _slabs.take(n);
         if (init.empty() == false)
         {
-            std::copy(init.begin(), init.end(), ptr.get());
+            std::copy(init.begin(), init.end(), blob);
         }
 
-        auto& blob = _blobs.emplace_back(std::make_pair(std::move(ptr), n));
-        return blob.first.get();
+        return blob;
+    }
+
+    /***
+     * Get the number of bytes the allocator holds memory for.
+     */
+    size_t retained() const
+    {
+        return _slabs.retained();
     }
 
 private:
-    std::vector<std::pair<std::unique_ptr<uint8_t[]>, size_t>> _blobs;
+    Detail::SlabPool<uint8_t, 4096, 1048576> _slabs;
 };
 } // namespace CBOR
 
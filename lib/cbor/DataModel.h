@@ -17,6 +17,17 @@ public:
     constexpr DataModel() :
         DataModelBase(_itemAllocator, _blobAllocator) {}
 
+    // the allocators with their full interface, e.g. DynamicItemAllocator::retained()
+    constexpr ItemAllocatorType& itemAllocator()
+    {
+        return _itemAllocator;
+    }
+
+    constexpr BlobAllocatorType& blobAllocator()
+    {
+        return _blobAllocator;
+    }
+
 private:
     ItemAllocatorType _itemAllocator;
 
@@ -1,13 +1,10 @@
 #include "DataModelBase.h"
 
-CBOR::DataModelBase::~DataModelBase()
-{
-    clear();
-}
+#include "Decoder.h"
 
 CBOR::Item CBOR::DataModelBase::createEmpty(Type type)
 {
-    clear();
+    reset();
 
     auto* root = _itemAllocator.allocate();
     if (root == nullptr)
@@ -18,4 +15,104 @@ CBOR::Item CBOR::DataModelBase::createEmpty(Type type)
     root->type = type;
     _root = Item(root, this);
     return _root;
+}
+
+CBOR::Error CBOR::DataModelBase::materialize(item_t* item)
+{
+    const DecodeOptions options{
+        .maxDepth = _maxDepth,
+        .lazy = true,
+        .borrow = _borrow,
+        .validateUtf8 = _validateUtf8,
+        .limits = _limits,
+        .sink = nullptr,
+        .sinkThreshold = DEFAULT_SINK_THRESHOLD
+    };
+
+    Decoder decoder(*this, options);
+
+    const auto error = decoder.materialize(item);
+    if (error != Error::OK && _error == Error::OK)
+    {
+        _error = error;
+    }
+
+    return error;
+}
+
+CBOR::Error CBOR::DataModelBase::detach()
+{
+    // everything decoded from now on is copied
+    _borrow = false;
+
+    // iterative pre-order walk, the children of a lazy container are decoded before it is descended into
+    auto* root = _root._item;
+    auto* item = root;
+    while (item != nullptr)
+    {
+        if (item->key != nullptr)
+        {
+            if (const auto error = own(item->key); error != Error::OK)
+            {
+                return error;
+            }
+        }
+
+        if (const auto error = own(item); error != Error::OK)
+        {
+            return error;
+        }
+
+        if ((item->type == Type::ARRAY || item->type == Type::MAP) && item->members.children.first != nullptr)
+        {
+            item = item->members.children.first;
+            continue;
+        }
+
+        while (item != root && item->sibling == nullptr)
+        {
+            item = item->parent;
+        }
+
+        item = item == root ? nullptr : item->sibling;
+    }
+
+    _source = {};
+
+    return Error::OK;
+}
+
+CBOR::Error CBOR::DataModelBase::own(item_t* item)
+{
+    if ((item->flags & item_t::LAZY) != 0)
+    {
+        return materialize(item);
+    }
+
+    if ((item->flags & item_t::BORROWED) == 0)
+    {
+        return Error::OK;
+    }
+
+    const auto bytes = item->type == Type::BYTES ? item->members.value.blob :
+        std::span<const uint8_t>((const uint8_t*)item->members.value.text.data(), item->members.value.text.size());
+
+    auto* blob = _blobAllocator.allocate(bytes.size(), bytes);
+    if (blob == nullptr && bytes.empty() == false)
+    {
+        return Error::BLOB_ALLOC_FAILED;
+    }
+
+    if (item->type == Type::BYTES)
+    {
+        item->members.value.blob = std::span<const uint8_t>(blob, bytes.size());
+    }
+    else
+    {
+        item->members.value.text = std::span<const char>((const char*)blob, bytes.size());
+    }
+
+    item->flags &= ~item_t::BORROWED;
+
+    return Error::OK;
 }
\ No newline at end of file
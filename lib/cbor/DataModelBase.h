@@ -1,9 +1,13 @@
 #ifndef BORON_CBOR_DATAMODELBASE_H_
 #define BORON_CBOR_DATAMODELBASE_H_
 
+#include <memory>
+#include <vector>
+
 #include "Types.h"
 #include "Item.h"
 #include "Allocators.h"
+#include "Limits.h"
 
 namespace CBOR
 {
@@ -13,11 +17,13 @@ class DataModelBase
 {
 public:
     friend Decoder;
+    friend Item;
 
     constexpr DataModelBase(ItemAllocator& itemAllocator, BlobAllocator& blobAllocator) :
         _itemAllocator(itemAllocator), _blobAllocator(blobAllocator) {}
 
-    ~DataModelBase();
+    // the allocators are owned (and released) by the derived model, they are already destroyed at this point
+    ~DataModelBase() = default;
 
     Item createEmpty(Type type);
 
@@ -36,18 +42,128 @@ public:
         return _blobAllocator;
     }
 
+    /***
+     * Clear the model and release the memory of the allocators.
+     */
     void clear()
     {
         _itemAllocator.clear();
         _blobAllocator.clear();
+        clearState();
+    }
+
+    /***
+     * Clear the model but keep the memory of the allocators for the next message, a model that is reused
+     * for messages of similar size then allocates nothing after the first. The Decoder resets the model
+     * before every message.
+     * 
+     * @param policy How much memory is kept, ResetPolicy::SHRINK releases what a larger message before took.
+     */
+    void reset(ResetPolicy policy = ResetPolicy::KEEP)
+    {
+        _itemAllocator.reset(policy);
+        _blobAllocator.reset(policy);
+        clearState();
+    }
+
+    /***
+     * Make room for @p items more items and @p bytes more bytes of strings, e.g. as determined by measure().
+     * A dynamic model allocates each of them at once.
+     * 
+     * @param items The number of items.
+     * @param bytes The number of bytes.
+     * 
+     * @return Error::ITEM_ALLOC_FAILED or Error::BLOB_ALLOC_FAILED if they exceed a static allocator.
+     */
+    Error reserve(size_t items, size_t bytes)
+    {
+        if (_itemAllocator.reserve(items) == false)
+        {
+            return Error::ITEM_ALLOC_FAILED;
+        }
+        else if (_blobAllocator.reserve(bytes) == false)
+        {
+            return Error::BLOB_ALLOC_FAILED;
+        }
+
+        return Error::OK;
+    }
+
+    /***
+     * Get the input the model is bound to, i.e. the input borrowed strings and lazy containers refer to.
+     * 
+     * @return The input, empty if the model is self-contained.
+     */
+    constexpr std::span<const uint8_t> source() const
+    {
+        return _source;
+    }
+
+    /***
+     * Make the model self-contained so that the input can be released: borrowed strings are copied to the
+     * blob allocator and lazy containers are decoded.
+     * 
+     * @return Error
+     */
+    Error detach();
+
+    /***
+     * Get the first error that occurred while decoding a lazy array or map on access (see DecodeOptions::lazy).
+     * A container whose children could not be decoded appears to be empty.
+     * 
+     * @return Error
+     */
+    constexpr Error error() const
+    {
+        return _error;
     }
 
 private:
+    void clearState()
+    {
+        _root = Item();
+        _adopted.clear();
+        _error = Error::OK;
+        _source = {};
+        _borrow = false;
+        _validateUtf8 = false;
+        _limits = {};
+        _maxDepth = DEFAULT_MAX_DEPTH;
+    }
+
+    /***
+     * Decode the children of a lazy array or map.
+     */
+    Error materialize(item_t* item);
+
+    /***
+     * Decode a lazy item and copy a borrowed one.
+     */
+    Error own(item_t* item);
+
     Item _root;
 
     ItemAllocator& _itemAllocator;
 
     BlobAllocator& _blobAllocator;
+
+    // models decoded in parallel whose items were linked into this one (see Decoder::decodeParallel())
+    std::vector<std::shared_ptr<void>> _adopted;
+
+    Error _error = Error::OK;
+
+    std::span<const uint8_t> _source;
+
+    // strings of lazy containers are borrowed as well
+    bool _borrow = false;
+
+    // text strings of lazy containers are checked as well
+    bool _validateUtf8 = false;
+
+    // lazy containers are decoded within the budgets and the nesting limit of the message
+    DecodeLimits _limits;
+
+    size_t _maxDepth = DEFAULT_MAX_DEPTH;
 };
 } // namespace CBOR
 
@@ -1,22 +1,43 @@
 #include "Decoder.h"
 
 #include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <tuple>
 
 #include "Bytes.h"
+#include "Float16.h"
+#include "Utf8.h"
+#include "Decoding.h"
+#include "InitTable.h"
+#include "Reader.h"
+#include "Shards.h"
 
 namespace
 {
+// frames preallocated for the container stack, enough for all but pathologically nested documents
+constexpr size_t INITIAL_STACK_CAPACITY = 64;
+
+// calls of Decoder::decodeNext() between two reads of the clock
+constexpr uint32_t DEADLINE_INTERVAL = 256;
+
+// largest window acquired from the sink at once, buffers that stage their output never need more
+constexpr size_t SINK_WINDOW_SIZE = 64 * 1024;
+
 constexpr CBOR::item_t createInteger(uint64_t value, CBOR::item_t *parent)
 {
     return CBOR::item_t(CBOR::Type::INTEGER, parent, CBOR::item_t::Members(value));
 }
 
-constexpr CBOR::item_t createByteString(std::span<uint8_t> bytes, CBOR::item_t *parent)
+constexpr CBOR::item_t createByteString(std::span<const uint8_t> bytes, CBOR::item_t *parent)
 {
     return CBOR::item_t(CBOR::Type::BYTES, parent, CBOR::item_t::Members(bytes));
 }
 
-constexpr CBOR::item_t createTextString(std::span<char> text, CBOR::item_t *parent)
+constexpr CBOR::item_t createTextString(std::span<const char> text, CBOR::item_t *parent)
 {
     return CBOR::item_t(CBOR::Type::STRING, parent, CBOR::item_t::Members(text));
 }
@@ -49,325 +70,767 @@ constexpr CBOR::item_t createSimple(CBOR::Simple value, CBOR::item_t* parent)
 
 std::pair<CBOR::Error, size_t> CBOR::Decoder::decode(std::span<const uint8_t> data)
 {
+    reset();
+
     if (data.empty())
     {
         return std::make_pair(Error::UNEXPECTED_EOF, 0);
     }
 
-    _data = data;
-    
-    _model._root = decodeAnything();
+    _model.reset();
+
+    // the model is bound to the input while anything refers to it
+    _model._source = (_lazy || _borrow) ? data : std::span<const uint8_t>();
+    _model._borrow = _borrow;
+    _model._validateUtf8 = _validateUtf8;
+    _model._limits = _limits;
+    _model._maxDepth = _maxDepth;
 
-    return std::make_pair(_error, _bytesUsed);
+    _input = SpanInputBuffer(data);
+    while (_complete == false)
+    {
+        if (const auto error = decodeNext(); error != Error::OK)
+        {
+            return std::make_pair(error, _input.size());
+        }
+    }
+
+    return std::make_pair(Error::OK, _input.size());
 }
 
-CBOR::item_t* CBOR::Decoder::decodeAnything()
+std::pair<CBOR::Error, size_t> CBOR::Decoder::decodeSequence(std::span<const uint8_t> data, size_t count)
 {
-    if (_data.empty())
+    // the items are decoded as the children of an array that is not part of the input, it does not count
+    // towards the depth
+    return decodeItems(data, Type::ARRAY, count, 0);
+}
+
+std::pair<CBOR::Error, size_t> CBOR::Decoder::decodeSelection(std::span<const uint8_t> source, std::span<const std::span<const uint8_t>> items)
+{
+    reset();
+
+    if (const auto error = checkLimits(1, 0, false); error != Error::OK)
     {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        return std::make_pair(error, 0);
     }
 
-    const auto init = InitByte(pop());
-    switch (init.majorType())
+    auto root = _model.createEmpty(Type::ARRAY);
+    if (bool(root) == false)
     {
-        case MajorType::UNSIGNED_INT:
-        case MajorType::SIGNED_INT:
-        {
-            return decodeInteger(init);
-        }
-        case MajorType::BYTE_STRING:
+        return std::make_pair(Error::ITEM_ALLOC_FAILED, 0);
+    }
+
+    _items = 1;
+    _model._source = (_lazy || _borrow) ? source : std::span<const uint8_t>();
+    _model._borrow = _borrow;
+    _model._validateUtf8 = _validateUtf8;
+    _model._limits = _limits;
+    _model._maxDepth = _maxDepth;
+
+    // every item is decoded as the only child left of the root, which does not count towards the depth
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        if (const auto error = checkLimits(1, 0, false); error != Error::OK)
         {
-            return decodeByteString(init);
+            return std::make_pair(error, i);
         }
-        case MajorType::TEXT_STRING:
+
+        _items++;
+        _input = SpanInputBuffer(items[i]);
+        _stack.push_back(Frame{ root._item, 1, nullptr, 0, false });
+        _complete = false;
+        while (_complete == false)
         {
-            return decodeTextString(init);
+            if (const auto error = decodeNext(); error != Error::OK)
+            {
+                return std::make_pair(error, i);
+            }
         }
-        case MajorType::ARRAY:
+    }
+
+    _complete = true;
+    return std::make_pair(Error::OK, items.size());
+}
+
+std::pair<CBOR::Error, size_t> CBOR::Decoder::decodeParallel(std::span<const uint8_t> data, size_t threads)
+{
+    reset();
+
+    // the header of the root and its tag
+    Reader reader(data);
+    auto [error, header] = reader.next();
+    auto tag = Tag::INVALID;
+    if (error == Error::OK && header.majorType() == MajorType::TAGGED)
+    {
+        tag = (Tag)header.argument();
+        std::tie(error, header) = reader.next();
+        if (error == Error::OK && header.majorType() == MajorType::TAGGED)
         {
-            return decodeArray(init);
+            error = Error::DOUBLE_TAGGED;
         }
-        case MajorType::MAP:
+    }
+
+    const auto splittable = error == Error::OK && header.isBreak() == false &&
+        (header.majorType() == MajorType::ARRAY || header.majorType() == MajorType::MAP);
+    // the budgets of items and blob bytes are shared by the whole message, it is decoded by a single decoder
+    const auto budgeted = _limits.maxItems != DecodeLimits::UNLIMITED || _limits.maxBlobBytes != DecodeLimits::UNLIMITED;
+    // and the strings have to reach the sink in order
+    if (splittable == false || budgeted || _sink != nullptr || data.size() < 2 * Detail::MIN_SHARD_SIZE || _maxDepth == 0)
+    {
+        return decode(data);
+    }
+
+    threads = Detail::threadCount(threads);
+    const auto shardSize = Detail::shardSize(data.size(), threads);
+    const auto type = header.majorType() == MajorType::MAP ? Type::MAP : Type::ARRAY;
+    const auto itemsPerElement = type == Type::MAP ? 2 : 1;
+
+    std::vector<Detail::Shard> shards;
+    Detail::Shard shard{ {}, 0, reader.position() };
+    size_t end = reader.position();
+    for (uint64_t elements = 0; ; ++elements)
+    {
+        end = reader.position();
+        if (header.indefinite() ? reader.readBreak() == Error::OK : elements == header.argument())
         {
-            return decodeMap(init);
+            break;
         }
-        case MajorType::TAGGED:
+
+        // a map is only split between a value and the next key
+        for (int i = 0; i < itemsPerElement; ++i)
         {
-            return decodeTagged(init);
+            if (const auto skipError = reader.skip(); skipError != Error::OK)
+            {
+                return std::make_pair(skipError, reader.position());
+            }
         }
-        case MajorType::FLOAT_OR_SIMPLE:
+
+        shard.count += itemsPerElement;
+        if (reader.position() - shard.offset >= shardSize)
         {
-            return decodeFloatOrSimple(init);
+            shard.data = data.subspan(shard.offset, reader.position() - shard.offset);
+            shards.push_back(shard);
+            shard = Detail::Shard{ {}, 0, reader.position() };
         }
     }
 
-    return nullptr;
-}
-
-CBOR::item_t* CBOR::Decoder::decodeInteger(InitByte init)
-{
-    int64_t value = 0;
-    if (init.argument() <= MAX_ARGUMENT_VALUE_IN_REMAINDER)
+    if (shard.count > 0)
     {
-        value = (int64_t)init.argument();
+        shard.data = data.subspan(shard.offset, end - shard.offset);
+        shards.push_back(shard);
     }
-    else
+
+    std::vector<std::unique_ptr<DynamicDataModel>> models(shards.size());
+    std::vector<std::pair<Error, size_t>> results(shards.size(), std::make_pair(Error::OK, 0));
+
+    const DecodeOptions options{ _maxDepth, _lazy, _borrow, _validateUtf8, _limits, nullptr, DEFAULT_SINK_THRESHOLD };
+    Detail::runShards(shards.size(), threads, [&](size_t i)
+    {
+        models[i] = std::make_unique<DynamicDataModel>();
+
+        Decoder decoder(*models[i], options);
+        results[i] = decoder.decodeItems(shards[i].data, type, shards[i].count, 1);
+    });
+
+    for (size_t i = 0; i < shards.size(); ++i)
     {
-        auto tmp = popArgument<int64_t>((ArgumentType)init.argument());
-        if (tmp.has_value() == false)
+        if (results[i].first != Error::OK)
         {
-            _error = Error::UNEXPECTED_EOF;
-            return nullptr;
+            return std::make_pair(results[i].first, shards[i].offset + results[i].second);
         }
-
-        value = *tmp;
     }
 
-    auto* item = _model.itemAllocator().allocate();
-    if (item == nullptr)
+    auto root = _model.createEmpty(type);
+    if (bool(root) == false)
     {
-        _error = Error::ITEM_ALLOC_FAILED;
-        return nullptr;
+        return std::make_pair(Error::ITEM_ALLOC_FAILED, 0);
     }
 
-    if (init.majorType() == MajorType::SIGNED_INT)
+    root._item->tag = tag;
+    _model._source = (_lazy || _borrow) ? data : std::span<const uint8_t>();
+    _model._borrow = _borrow;
+    _model._validateUtf8 = _validateUtf8;
+    _model._limits = _limits;
+    _model._maxDepth = _maxDepth;
+
+    // the children of the shard roots become the children of the root, in order
+    auto& children = root._item->members.children;
+    for (auto& model : models)
     {
-        value = INT16_C(-1) - value;
-    }
+        auto* shardRoot = model->root()._item;
+        for (auto* child = shardRoot->members.children.first; child != nullptr; child = child->sibling)
+        {
+            child->parent = root._item;
+            if (child->key != nullptr)
+            {
+                child->key->parent = root._item;
+            }
+        }
 
-    *item = createInteger(value, _current);
+        if (children.first == nullptr)
+        {
+            children.first = shardRoot->members.children.first;
+        }
+        else
+        {
+            children.last->sibling = shardRoot->members.children.first;
+        }
+
+        children.last = shardRoot->members.children.last;
+        _model._adopted.push_back(std::move(model));
+    }
 
-    return item;
+    _complete = true;
+    return std::make_pair(Error::OK, reader.position());
 }
 
-CBOR::item_t* CBOR::Decoder::decodeByteString(InitByte init)
+std::pair<CBOR::Error, size_t> CBOR::Decoder::decodeItems(std::span<const uint8_t> data, Type type, uint64_t count, size_t depth)
 {
-    const auto length = popArgument<int64_t>((ArgumentType)init.argument());
-    if (length.has_value() == false)
+    reset();
+
+    // the root and the items
+    const auto items = count == UINT64_MAX ? count : count + 1;
+    if (const auto error = checkLimits(items, 0, false); error != Error::OK)
     {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        return std::make_pair(error, 0);
     }
 
-    auto* item = _model.itemAllocator().allocate();
-    if (item == nullptr)
+    auto root = _model.createEmpty(type);
+    if (bool(root) == false)
     {
-        _error = Error::ITEM_ALLOC_FAILED;
-        return nullptr;
+        return std::make_pair(Error::ITEM_ALLOC_FAILED, 0);
     }
 
-    if (_data.size() < length)
+    _items = items;
+    _model._source = (_lazy || _borrow) ? data : std::span<const uint8_t>();
+    _model._borrow = _borrow;
+    _model._validateUtf8 = _validateUtf8;
+    _model._limits = _limits;
+    _model._maxDepth = _maxDepth;
+
+    if (count == 0)
     {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        return std::make_pair(Error::OK, 0);
     }
 
-    auto* blob = _model.blobAllocator().allocate(*length, pop(*length));
-    if (blob == nullptr)
+    _input = SpanInputBuffer(data);
+    _stack.push_back(Frame{ root._item, count, nullptr, depth, false });
+    while (_complete == false)
     {
-        _error = Error::BLOB_ALLOC_FAILED;
-        return nullptr;
+        if (const auto error = decodeNext(); error != Error::OK)
+        {
+            return std::make_pair(error, _input.size());
+        }
     }
 
-    *item = createByteString({blob, (size_t)*length}, _current);
+    return std::make_pair(Error::OK, _input.size());
+}
 
-    return item;
+std::pair<CBOR::Error, size_t> CBOR::Decoder::feed(std::span<const uint8_t> data)
+{
+    // the chunks do not outlive the call, lazy containers and borrowed strings could not refer to them
+    const auto lazy = std::exchange(_lazy, false);
+    const auto borrow = std::exchange(_borrow, false);
+    const auto result = feedChunk(data);
+    _lazy = lazy;
+    _borrow = borrow;
+
+    return result;
 }
 
-CBOR::item_t* CBOR::Decoder::decodeTextString(InitByte init)
+std::pair<CBOR::Error, size_t> CBOR::Decoder::feedChunk(std::span<const uint8_t> data)
 {
-    const auto length = popArgument<int64_t>((ArgumentType)init.argument());
-    if (length.has_value() == false)
+    if (_complete)
     {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        return std::make_pair(Error::OK, 0);
     }
 
-    auto* item = _model.itemAllocator().allocate();
-    if (item == nullptr)
+    // the first chunk of a message
+    if (_started == false)
     {
-        _error = Error::ITEM_ALLOC_FAILED;
-        return nullptr;
+        _model.reset();
+        _started = true;
     }
 
-    if (_data.size() < *length)
+    size_t used = 0;
+
+    // first complete the item that was cut off by the end of the previous chunk
+    while (_pending.empty() == false || _sinkRemaining > 0)
     {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        if (_sinkRemaining > 0)
+        {
+            // the payload of a sunk string is passed on as it arrives
+            const auto n = (size_t)std::min<uint64_t>(data.size() - used, _sinkRemaining);
+            if (const auto error = sinkPart(data.subspan(used, n)); error != Error::OK)
+            {
+                return std::make_pair(error, used);
+            }
+
+            used += n;
+            if (_sinkRemaining > 0)
+            {
+                return std::make_pair(Error::UNEXPECTED_EOF, used);
+            }
+
+            if (const auto error = attach(std::exchange(_sinking, nullptr)); error != Error::OK)
+            {
+                return std::make_pair(error, used);
+            }
+
+            continue;
+        }
+
+        const auto n = std::min(data.size() - used, _needed - _pending.size());
+        _pending.insert(_pending.end(), data.begin() + used, data.begin() + used + n);
+        used += n;
+
+        if (_pending.size() < _needed)
+        {
+            return std::make_pair(Error::UNEXPECTED_EOF, used);
+        }
+
+        _input = SpanInputBuffer(_pending);
+        const auto error = decodeNext();
+        if (error == Error::UNEXPECTED_EOF)
+        {
+            // the header is complete now and revealed the length of the payload, the header of a sunk
+            // string is used up
+            if (_sinkRemaining > 0)
+            {
+                _pending.clear();
+            }
+            else if (_needed <= _pending.size())
+            {
+                // more input would not complete the item
+                return std::make_pair(Error::MALFORMED_MESSAGE, used);
+            }
+
+            continue;
+        }
+        else if (error != Error::OK)
+        {
+            return std::make_pair(error, used);
+        }
+
+        _pending.clear();
     }
 
-    auto* blob = _model.blobAllocator().allocate(*length, pop(*length));
-    if (blob == nullptr)
+    _input = SpanInputBuffer(data.subspan(used));
+    while (_complete == false)
     {
-        _error = Error::BLOB_ALLOC_FAILED;
-        return nullptr;
+        const auto error = decodeNext();
+        if (error == Error::UNEXPECTED_EOF)
+        {
+            const auto unread = _input.unread();
+            _pending.assign(unread.begin(), unread.end());
+            return std::make_pair(Error::UNEXPECTED_EOF, data.size());
+        }
+        else if (error != Error::OK)
+        {
+            return std::make_pair(error, used + _input.size());
+        }
     }
 
-    *item = createTextString({(char*)blob, (size_t)*length}, _current);
+    return std::make_pair(Error::OK, used + _input.size());
+}
 
-    return item;
+void CBOR::Decoder::reset()
+{
+    _input = SpanInputBuffer({});
+    _stack.clear();
+    _pending.clear();
+    _needed = 0;
+    _tag = Tag::INVALID;
+    _complete = false;
+    _started = false;
+    _items = 0;
+    _blobBytes = 0;
+    _steps = 0;
+    _sinking = nullptr;
+    _sinkRemaining = 0;
+    _sinkUtf8 = false;
+    _utf8.reset();
 }
 
-CBOR::item_t* CBOR::Decoder::decodeArray(InitByte init)
+CBOR::Error CBOR::Decoder::materialize(item_t* container)
 {
-    const auto length = popArgument<uint64_t>((ArgumentType)init.argument());
-    if (length.has_value() == false)
+    if ((container->flags & item_t::LAZY) == 0)
     {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        return Error::OK;
     }
 
-    auto* array = _model.itemAllocator().allocate();
-    if (array == nullptr)
+    reset();
+
+    _input = SpanInputBuffer(container->members.value.encoding);
+    const auto [error, header] = Decoding::decode(_input);
+    if (error != Error::OK)
     {
-       _error = Error::ITEM_ALLOC_FAILED;
-        return nullptr;
+        return error;
     }
 
-    *array = createArray(_current);
-    _current = array;
+    container->flags &= ~item_t::LAZY;
+    container->members.children.first = nullptr;
+    container->members.children.last = nullptr;
 
-    for (size_t i = 0; i < (size_t)*length; ++i)
+    // the extent was checked on the first pass, a container of definite length is not empty. Its children
+    // are nested as deep as they are in the message
+    _stack.push_back(Frame{ container, container->type == Type::MAP ? header.argument() * 2 : header.argument(), nullptr, container->depth, header.indefinite() });
+    while (_complete == false)
     {
-        auto* item = decodeAnything();
-        if (item == nullptr)
+        if (const auto error = decodeNext(); error != Error::OK)
         {
-            return nullptr;
+            // a container whose children could not be decoded appears to be empty, not truncated
+            container->members.children.first = nullptr;
+            container->members.children.last = nullptr;
+            return error;
         }
-
-        _current->addToChildren(item);
     }
 
-    _current = array->parent;
-
-    return array;
+    return Error::OK;
 }
 
-CBOR::item_t* CBOR::Decoder::decodeMap(InitByte init)
+CBOR::Error CBOR::Decoder::decodeNext()
 {
-    const auto numPairs = popArgument<int64_t>((ArgumentType)init.argument());
-    if (numPairs.has_value() == false)
+    // everything is checked before anything is allocated: an incomplete item is rewound to its start
+    // and only reports the number of bytes it needs
+    if (_limits.deadline != std::chrono::steady_clock::time_point::max() && (_steps++ % DEADLINE_INTERVAL) == 0 &&
+        std::chrono::steady_clock::now() >= _limits.deadline)
+    {
+        return Error::DEADLINE_EXCEEDED;
+    }
+
+    const auto mark = _input.mark();
+
+    uint8_t x = 0;
+    if (_input.read(x) == false)
     {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        _needed = 1;
+        return Error::UNEXPECTED_EOF;
     }
 
-    auto* map = _model.itemAllocator().allocate();
-    if (map == nullptr)
+    const auto& rule = INIT_TABLE[x];
+    if (rule.kind == InitKind::MALFORMED)
     {
-        _error = Error::ITEM_ALLOC_FAILED;
-        return nullptr;
+        return Error::MALFORMED_MESSAGE;
+    }
+    else if (rule.kind == InitKind::BREAK)
+    {
+        return decodeBreak();
     }
 
-    *map = createMap(_current);
-    _current = map;
+    // items of indefinite length are decoded like their definite counterparts
+    const auto indefinite = rule.kind == InitKind::INDEFINITE;
+    const auto kind = indefinite ? INIT_TABLE[(uint8_t)rule.majorType << 5].kind : rule.kind;
 
-    for (size_t i = 0; i < (size_t)*numPairs; ++i)
+    uint64_t argument = rule.additional;
+    if (rule.argumentLength > 0)
     {
-        auto* key = decodeAnything();
-        if (key == nullptr)
+        const auto available = _input.remaining();
+        const auto argumentBytes = _input.readSpan(rule.argumentLength);
+        if (argumentBytes.size() != rule.argumentLength)
         {
-            break;
+            _needed = 1 + rule.argumentLength;
+            _input.rewind(mark);
+            return Error::UNEXPECTED_EOF;
         }
 
-        if (key->type != Type::INTEGER && key->type != Type::STRING)
+        argument = loadArgument(argumentBytes.data(), rule.argumentLength, available);
+        if (argument < rule.minimum)
         {
-            _error = Error::UNSUPPORTED_KEY_TYPE;
-            return nullptr;
+            return Error::MALFORMED_ARGUMENT;
         }
+    }
 
-        auto* value = decodeAnything();
-        if (value == nullptr)
+    // declared lengths are charged before the payload or the children are waited for, an item in a container
+    // of definite length was charged with the container
+    const auto isString = kind == InitKind::BYTE_STRING || kind == InitKind::TEXT_STRING;
+
+    // keys are needed to look up their values and are never sunk, the length of a string of indefinite
+    // length is only known once its chunks are scanned
+    const auto isKey = _stack.empty() == false && _stack.back().container->type == Type::MAP && _stack.back().key == nullptr;
+    const auto sinkable = isString && _sink != nullptr && isKey == false;
+    auto sunk = sinkable && indefinite == false && argument > _sinkThreshold;
+    uint64_t items = 0;
+    if (kind != InitKind::TAGGED)
+    {
+        items = (_stack.empty() || _stack.back().indefinite) ? 1 : 0;
+        if ((kind == InitKind::ARRAY || kind == InitKind::MAP) && indefinite == false && _lazy == false)
         {
-            break;
+            const auto children = kind == InitKind::MAP ? (argument > UINT64_MAX / 2 ? UINT64_MAX : argument * 2) : argument;
+            items = children == UINT64_MAX ? children : children + items;
         }
-
-        value->key = key;
-
-        map->addToChildren(value);
     }
-    _current = map->parent;
-    
-    return map;
-}
 
-CBOR::item_t* CBOR::Decoder::decodeTagged(InitByte init)
-{
-    const auto tag = popArgument<uint64_t>((ArgumentType)init.argument());
-    if (tag.has_value() == false)
+    if (const auto error = checkLimits(items, (isString && indefinite == false) ? argument : 0, _borrow == false && sunk == false); error != Error::OK)
     {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        return error;
     }
 
-    auto* tagged = decodeAnything();
-    if (tagged == nullptr)
+    std::span<const uint8_t> payload;
+    if (rule.payload == PayloadRule::LENGTH)
     {
-        return nullptr;
-    }
-
-    tagged->tag = (Tag)*tag;
-
-    return tagged;
-}
+        if (_input.remaining() < argument && sunk == false)
+        {
+            // the item could never be buffered and the number of bytes it needs would wrap
+            if (argument > SIZE_MAX - 1 - rule.argumentLength)
+            {
+                return Error::STRING_TOO_LONG;
+            }
+
+            _needed = 1 + rule.argumentLength + argument;
+            _input.rewind(mark);
+            return Error::UNEXPECTED_EOF;
+        }
 
-CBOR::item_t* CBOR::Decoder::decodeFloatOrSimple(InitByte init)
-{
-    const auto argument = popArgument<uint64_t>((ArgumentType)init.argument());
-    if (argument.has_value() == false)
-    {
-        _error = Error::UNEXPECTED_EOF;
-        return nullptr;
+        // a sunk string does not wait for the rest of its payload
+        payload = _input.readSpan((size_t)std::min<uint64_t>(argument, _input.remaining()));
     }
 
-    switch ((FloatOrSimpleArgumentType)*argument)
+    // the chunks of a string of indefinite length are scanned first, so that it is copied to a single blob
+    Decoding::Chunks chunks;
+    SpanInputBuffer chunkInput({});
+    if (indefinite && (kind == InitKind::BYTE_STRING || kind == InitKind::TEXT_STRING))
     {
-        case FloatOrSimpleArgumentType::FALSE:
-        case FloatOrSimpleArgumentType::TRUE:
-        case FloatOrSimpleArgumentType::NULLVAL:
-        case FloatOrSimpleArgumentType::UNDEFINED:
+        const auto result = Decoding::scanChunks(_input.unread(), rule.majorType);
+        if (result.first == Error::UNEXPECTED_EOF)
         {
-            return decodeSimple(init);
+            // a chunk that could never be buffered
+            if (result.second.size == SIZE_MAX)
+            {
+                return Error::STRING_TOO_LONG;
+            }
+
+            _needed = 1 + result.second.size;
+            _input.rewind(mark);
+            return Error::UNEXPECTED_EOF;
         }
-        case FloatOrSimpleArgumentType::FLOAT32:
-        case FloatOrSimpleArgumentType::FLOAT64:
+        else if (result.first != Error::OK)
         {
-            return decodeFloat(init);
+            return result.first;
         }
-        case FloatOrSimpleArgumentType::BREAK:
-        default:
+
+        chunks = result.second;
+        sunk = sinkable && chunks.length > _sinkThreshold;
+        if (const auto error = checkLimits(0, chunks.length, sunk == false); error != Error::OK)
         {
-            _error = Error::MALFORMED_MESSAGE;
-            return nullptr;
+            return error;
         }
+
+        // the extent of the chunks is known now, they are read from a child buffer that ends at the break
+        chunkInput = _input.slice(chunks.size);
+        payload = chunkInput.unread();
     }
 
-    return nullptr;
-}
+    if (rule.kind == InitKind::SIMPLE && (argument < (uint64_t)FloatOrSimpleArgumentType::FALSE || argument > (uint64_t)FloatOrSimpleArgumentType::UNDEFINED))
+    {
+        return Error::UNSUPPORTED_SIMPLE;
+    }
+
+    // the payload of a sunk string of definite length may be incomplete, it is validated as it is passed on
+    if (_validateUtf8 && kind == InitKind::TEXT_STRING && (sunk && indefinite == false) == false &&
+        (indefinite ? Decoding::validateChunks(payload) : Utf8::validate(payload)) == false)
+    {
+        return Error::INVALID_UTF8;
+    }
+
+    if (kind == InitKind::TAGGED)
+    {
+        if (_tag != Tag::INVALID)
+        {
+            return Error::DOUBLE_TAGGED;
+        }
+
+        _tag = (Tag)argument;
+        return Error::OK;
+    }
 
-CBOR::item_t* CBOR::Decoder::decodeFloat(InitByte init)
-{
     auto* item = _model.itemAllocator().allocate();
     if (item == nullptr)
     {
-        _error = Error::ITEM_ALLOC_FAILED;
-        return nullptr;
+        return Error::ITEM_ALLOC_FAILED;
     }
 
-    Float value = 0;
-    switch ((FloatOrSimpleArgumentType)init.argument())
+    _items += items;
+
+    switch (kind)
     {
-        case FloatOrSimpleArgumentType::FLOAT32:
+        case InitKind::UNSIGNED_INT:
         {
-            value = (double)Bytes::fromBytes<float>(pop(sizeof(float)));
-            break;
+            *item = createInteger(argument, nullptr);
+            return attach(item);
         }
-        case FloatOrSimpleArgumentType::FLOAT64:
+        case InitKind::SIGNED_INT:
         {
-            value = Bytes::fromBytes<double>(pop(sizeof(double)));
-            break;
+            *item = createInteger((uint64_t)(INT64_C(-1) - (int64_t)argument), nullptr);
+            return attach(item);
+        }
+        case InitKind::BYTE_STRING:
+        case InitKind::TEXT_STRING:
+        {
+            if (sunk)
+            {
+                // the model keeps a placeholder, the string is attached once its payload is passed on
+                item->type = kind == InitKind::BYTE_STRING ? Type::BYTES : Type::STRING;
+                item->members.value.sunk = { _sink->size(), indefinite ? chunks.length : argument };
+                item->flags |= item_t::SUNK;
+
+                _sinking = item;
+                _sinkRemaining = item->members.value.sunk.length;
+                _sinkUtf8 = _validateUtf8 && kind == InitKind::TEXT_STRING && indefinite == false;
+                _utf8.reset();
+
+                if (indefinite)
+                {
+                    for (auto chunk = Decoding::decode(chunkInput); chunk.first == Error::OK && chunk.second.isBreak() == false; chunk = Decoding::decode(chunkInput))
+                    {
+                        if (const auto error = sinkPart(chunk.second.payload()); error != Error::OK)
+                        {
+                            return error;
+                        }
+                    }
+                }
+                else if (const auto error = sinkPart(payload); error != Error::OK)
+                {
+                    return error;
+                }
+
+                if (_sinkRemaining > 0)
+                {
+                    // feed() passes the rest of the payload as it arrives
+                    _needed = 0;
+                    return Error::UNEXPECTED_EOF;
+                }
+
+                return attach(std::exchange(_sinking, nullptr));
+            }
+
+            // chunked strings are not contiguous in the input and are always copied
+            const auto borrow = _borrow && indefinite == false;
+            const auto length = indefinite ? (size_t)chunks.length : payload.size();
+
+            const uint8_t* blob = payload.data();
+            if (borrow == false)
+            {
+                _blobBytes += length;
+                auto* copy = _model.blobAllocator().allocate(length, indefinite ? std::span<const uint8_t>() : payload);
+                if (copy == nullptr && length > 0)
+                {
+                    return Error::BLOB_ALLOC_FAILED;
+                }
+
+                if (indefinite && length > 0)
+                {
+                    Decoding::copyChunks(payload, copy);
+                }
+
+                blob = copy;
+            }
+
+            if (kind == InitKind::BYTE_STRING)
+            {
+                *item = createByteString({blob, length}, nullptr);
+            }
+            else
+            {
+                *item = createTextString({(const char*)blob, length}, nullptr);
+            }
+
+            if (borrow)
+            {
+                item->flags |= item_t::BORROWED;
+            }
+
+            return attach(item);
+        }
+        case InitKind::ARRAY:
+        case InitKind::MAP:
+        {
+            const auto isMap = kind == InitKind::MAP;
+            if (isMap && argument > (UINT64_MAX / 2))
+            {
+                return Error::MALFORMED_MESSAGE;
+            }
+
+            // frames are popped as soon as their last child starts, so the depth is tracked explicitly
+            const auto depth = _stack.empty() ? 1 : _stack.back().depth + 1;
+            if (depth > _maxDepth)
+            {
+                return Error::MAXIMUM_DEPTH_EXCEEDED;
+            }
+
+            *item = isMap ? createMap(nullptr) : createArray(nullptr);
+
+            if (_lazy && (argument > 0 || indefinite))
+            {
+                // only the extent of the container is determined, its children are decoded on first access
+                _input.rewind(mark);
+
+                Reader reader(_input.unread());
+                if (const auto error = reader.skip(); error != Error::OK)
+                {
+                    return error;
+                }
+
+                item->members.value.encoding = _input.readSpan(reader.position());
+                item->flags |= item_t::LAZY;
+                item->depth = (uint32_t)depth;
+
+                return attach(item);
+            }
+
+            if (const auto error = attach(item); error != Error::OK)
+            {
+                return error;
+            }
+
+            if (argument > 0 || indefinite)
+            {
+                if (_stack.capacity() == 0)
+                {
+                    _stack.reserve(std::min(_maxDepth, INITIAL_STACK_CAPACITY));
+                }
+
+                _stack.push_back(Frame{ item, isMap ? argument * 2 : argument, nullptr, depth, indefinite });
+                _complete = false;
+            }
+
+            return Error::OK;
+        }
+        case InitKind::FLOAT:
+        {
+            switch (rule.argumentLength)
+            {
+                case sizeof(uint16_t):
+                {
+                    *item = createFloat((Float)Float16::toFloat((uint16_t)argument), nullptr);
+                    break;
+                }
+                case sizeof(float):
+                {
+                    *item = createFloat((Float)std::bit_cast<float>((uint32_t)argument), nullptr);
+                    break;
+                }
+                default:
+                {
+                    *item = createFloat(std::bit_cast<double>(argument), nullptr);
+                    break;
+                }
+            }
+
+            return attach(item);
+        }
+        case InitKind::SIMPLE:
+        {
+            if (rule.additional == (uint8_t)FloatOrSimpleArgumentType::FALSE || rule.additional == (uint8_t)FloatOrSimpleArgumentType::TRUE)
+            {
+                *item = createBool(rule.additional == (uint8_t)FloatOrSimpleArgumentType::TRUE, nullptr);
+            }
+            else
+            {
+                *item = createSimple(rule.additional == (uint8_t)FloatOrSimpleArgumentType::NULLVAL ? Simple::NULLVAL : Simple::UNDEFINED, nullptr);
+            }
+
+            return attach(item);
         }
         default:
         {
@@ -375,48 +838,120 @@ CBOR::item_t* CBOR::Decoder::decodeFloat(InitByte init)
         }
     }
 
-    *item = createFloat(value, _current);
+    return Error::MALFORMED_MESSAGE;
+}
+
+CBOR::Error CBOR::Decoder::checkLimits(uint64_t items, uint64_t length, bool copied) const
+{
+    if (_limits.maxItems != DecodeLimits::UNLIMITED && items > _limits.maxItems - _items)
+    {
+        return Error::ITEM_LIMIT_EXCEEDED;
+    }
+    else if (length > _limits.maxStringLength)
+    {
+        return Error::STRING_TOO_LONG;
+    }
+    else if (copied && _limits.maxBlobBytes != DecodeLimits::UNLIMITED && length > _limits.maxBlobBytes - _blobBytes)
+    {
+        return Error::BLOB_LIMIT_EXCEEDED;
+    }
 
-    return item;
+    return Error::OK;
 }
 
-CBOR::item_t* CBOR::Decoder::decodeSimple(InitByte init)
+CBOR::Error CBOR::Decoder::sinkPart(std::span<const uint8_t> bytes)
 {
-    auto* item = _model.itemAllocator().allocate();
-    if (item == nullptr)
+    if (_sinkUtf8 && _utf8.feed(bytes) == false)
     {
-        _error = Error::ITEM_ALLOC_FAILED;
-        return nullptr;
+        return Error::INVALID_UTF8;
     }
 
-    switch ((FloatOrSimpleArgumentType)init.argument())
+    _sinkRemaining -= bytes.size();
+    if (_sinkUtf8 && _sinkRemaining == 0 && _utf8.complete() == false)
     {
-        case FloatOrSimpleArgumentType::FALSE:
-        {
-            *item = createBool(false, _current);
-            break;
-        }
-        case FloatOrSimpleArgumentType::TRUE:
-        {
-            *item = createBool(true, _current);
-            break;
-        }
-        case FloatOrSimpleArgumentType::NULLVAL:
-        {
-            *item = createSimple(Simple::NULLVAL, _current);
-            break;
-        }
-        case FloatOrSimpleArgumentType::UNDEFINED:
+        return Error::INVALID_UTF8;
+    }
+
+    // in bounded windows, so that buffers that stage their output never need a window of the whole string
+    while (bytes.empty() == false)
+    {
+        const auto window = _sink->acquire(std::min(bytes.size(), SINK_WINDOW_SIZE));
+        if (window.empty())
         {
-            *item = createSimple(Simple::UNDEFINED, _current);
-            break;
+            return Error::SINK_WRITE_FAILED;
         }
-        default:
+
+        const auto n = std::min(window.size(), bytes.size());
+        std::memcpy(window.data(), bytes.data(), n);
+        _sink->commit(n);
+
+        bytes = bytes.subspan(n);
+    }
+
+    return Error::OK;
+}
+
+CBOR::Error CBOR::Decoder::attach(item_t* item)
+{
+    item->tag = _tag;
+    _tag = Tag::INVALID;
+
+    if (_stack.empty())
+    {
+        _model._root = Item(item, &_model);
+        _complete = true;
+        return Error::OK;
+    }
+
+    auto& frame = _stack.back();
+    if (frame.container->type == Type::MAP && frame.key == nullptr)
+    {
+        if (item->type != Type::INTEGER && item->type != Type::STRING)
         {
-            _error = Error::UNSUPPORTED_SIMPLE;
-            return nullptr;
+            return Error::UNSUPPORTED_KEY_TYPE;
         }
+
+        item->parent = frame.container;
+        frame.key = item;
+    }
+    else
+    {
+        item->key = frame.key;
+        frame.key = nullptr;
+        frame.container->addToChildren(item);
+    }
+
+    if (frame.indefinite == false)
+    {
+        frame.remaining--;
+    }
+
+    popCompleted();
+
+    return Error::OK;
+}
+
+CBOR::Error CBOR::Decoder::decodeBreak()
+{
+    // a break is not an item, it ends the innermost container of indefinite length
+    if (_tag != Tag::INVALID || _stack.empty() || _stack.back().indefinite == false || _stack.back().key != nullptr)
+    {
+        return Error::MALFORMED_MESSAGE;
+    }
+
+    // the container was attached to its parent when it started
+    _stack.pop_back();
+    popCompleted();
+
+    return Error::OK;
+}
+
+void CBOR::Decoder::popCompleted()
+{
+    while (_stack.empty() == false && _stack.back().indefinite == false && _stack.back().remaining == 0)
+    {
+        _stack.pop_back();
     }
 
-    return item;
+    _complete = _stack.empty();
 }
\ No newline at end of file
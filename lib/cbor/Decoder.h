@@ -4,144 +4,297 @@
 #include <cstdint>
 
 #include <utility>
+#include <vector>
 
 #include "Types.h"
 #include "Item.h"
 #include "DataModel.h"
+#include "Limits.h"
 #include "Bytes.h"
+#include "Utf8.h"
 #include "../Buffers.h"
 
 namespace CBOR
 {
+/***
+ * Default length above which strings are written to the sink of the decoder (see DecodeOptions::sink).
+ */
+constexpr uint64_t DEFAULT_SINK_THRESHOLD = 64 * 1024;
+
+struct DecodeOptions
+{
+    /***
+     * The maximum nesting of arrays and maps, deeper input fails with Error::MAXIMUM_DEPTH_EXCEEDED.
+     */
+    size_t maxDepth = DEFAULT_MAX_DEPTH;
+
+    /***
+     * Decode the children of arrays and maps only when they are first accessed through the Item
+     * (begin(), operator[]). Until then a container only refers to its encoding, which must therefore
+     * outlive the model. Decoder::feed() always decodes eagerly.
+     */
+    bool lazy = false;
+
+    /***
+     * Let strings refer to the input instead of copying them to the blob allocator. The model is bound to
+     * the input until DataModelBase::detach() is called. Decoder::feed() always copies.
+     */
+    bool borrow = false;
+
+    /***
+     * Check that text strings are valid UTF-8, invalid ones fail with Error::INVALID_UTF8. Strings of lazy
+     * containers are checked when the container is decoded.
+     */
+    bool validateUtf8 = false;
+
+    DecodeLimits limits = {};
+
+    /***
+     * Write the payload of byte and text strings longer than sinkThreshold to this buffer instead of the
+     * blob allocator (e.g. a FileOutputBuffer for a firmware image inside a message). The model only keeps
+     * a placeholder with the position of the string in the sink and its length (see Item::isSunk()), sunk
+     * strings do not count towards DecodeLimits::maxBlobBytes. Keys of maps and the strings of lazy
+     * containers are not sunk. A callback is an OutputBuffer that consumes the bytes passed to commit().
+     * 
+     * Decoder::feed() passes the payload of a string of definite length to the sink as it arrives, memory
+     * stays bounded however long the string is. A string of indefinite length is passed once all of its
+     * chunks have arrived. If decoding fails, the sink may hold a part of a string.
+     */
+    OutputBuffer* sink = nullptr;
+
+    uint64_t sinkThreshold = DEFAULT_SINK_THRESHOLD;
+};
+
 class Decoder
 {
 public:
-    constexpr Decoder(DataModelBase& model) :
-        _model(model) {}
-
+    static constexpr size_t DEFAULT_MAX_DEPTH = CBOR::DEFAULT_MAX_DEPTH;
+
+    /***
+     * Create a decoder writing to @p model. Arrays and maps are decoded iteratively with an explicit
+     * stack, the depth of the input is therefore only limited by @p maxDepth and not by the thread's stack.
+     * 
+     * @param model The model to be filled.
+     * @param maxDepth The maximum nesting of arrays and maps, deeper input fails with Error::MAXIMUM_DEPTH_EXCEEDED.
+     */
+    constexpr Decoder(DataModelBase& model, size_t maxDepth = DEFAULT_MAX_DEPTH) :
+        _model(model), _maxDepth(maxDepth) {}
+
+    constexpr Decoder(DataModelBase& model, const DecodeOptions& options) :
+        _model(model), _maxDepth(options.maxDepth), _lazy(options.lazy), _borrow(options.borrow),
+        _validateUtf8(options.validateUtf8), _limits(options.limits), _sink(options.sink),
+        _sinkThreshold(options.sinkThreshold) {}
+
+    /***
+     * Decode a complete message. The model is reset first and keeps the memory of the previous message.
+     * 
+     * @param data The message.
+     * 
+     * @return A pair with the error and the number of bytes used.
+     */
     std::pair<Error, size_t> decode(std::span<const uint8_t> data);
 
-private:
-    constexpr uint8_t peek() const
+    /***
+     * Decode @p count consecutive items of an RFC 8742 sequence (concatenated messages) into a single model.
+     * The root of the model is an array and the items are its children.
+     * 
+     * @param data The sequence, it must contain at least @p count items.
+     * @param count The number of items.
+     * 
+     * @return A pair with the error and the number of bytes used.
+     */
+    std::pair<Error, size_t> decodeSequence(std::span<const uint8_t> data, size_t count);
+
+    /***
+     * Decode items that are not contiguous in the message (e.g. the matches of a Path) into a single model.
+     * The root of the model is an array and the items are its children, in the order given.
+     * 
+     * @param source The message, lazy and borrowed items refer to it.
+     * @param items The encodings of the items, each a part of @p source.
+     * 
+     * @return A pair with the error and the number of items decoded.
+     */
+    std::pair<Error, size_t> decodeSelection(std::span<const uint8_t> source, std::span<const std::span<const uint8_t>> items);
+
+    /***
+     * Decode a message whose root is a large array or map on multiple threads. The boundaries of the
+     * elements are determined by a scan of their headers (see Reader::skip()), consecutive elements are
+     * split into shards of about the same number of bytes, every shard is decoded concurrently into a model
+     * of its own and the children of the shards are linked in order to the root of the model. The model
+     * keeps the shard models alive until it is cleared.
+     * 
+     * Any other root, a message too small to be worth splitting and a decoder with budgets of items or
+     * blob bytes or with a sink are decoded as by decode().
+     * 
+     * @param data The message.
+     * @param threads The number of threads, 0 to use one per core.
+     * 
+     * @return A pair with the error and the number of bytes used.
+     */
+    std::pair<Error, size_t> decodeParallel(std::span<const uint8_t> data, size_t threads = 0);
+
+    /***
+     * Decode a message that arrives in arbitrary chunks (e.g. from a socket or a pipe). Every call
+     * continues the partially built model where the previous call stopped, no input is parsed twice.
+     * The bytes of an item that is cut off by the end of a chunk are kept until the item is complete,
+     * hence the model must not use the InlineBlobAllocator.
+     * 
+     * @param data The next chunk of the message.
+     * 
+     * @return A pair with the error and the number of bytes of @p data used. The error is Error::OK once
+     *         the message is complete (unused bytes belong to the next message), Error::UNEXPECTED_EOF if
+     *         all bytes were used and more are needed, any other error if the message is malformed.
+     */
+    std::pair<Error, size_t> feed(std::span<const uint8_t> data);
+
+    /***
+     * Reset the state of feed() to start decoding a new message.
+     */
+    void reset();
+
+    /***
+     * Check if the message passed to feed() is complete.
+     * 
+     * @return True if the message is complete, false otherwise.
+     */
+    constexpr bool complete() const
     {
-        return _data.empty() == false ? _data.front() : 0x00;
+        return _complete;
     }
 
-    constexpr uint8_t pop()
+    constexpr size_t maxDepth() const
     {
-        if (_data.empty())
-        {
-            return 0x00;
-        }
-
-        _bytesUsed++;
-
-        const uint8_t x = _data.front();
-        _data = _data.subspan(1);
-        return x;
+        return _maxDepth;
     }
 
-    constexpr std::span<const uint8_t> pop(size_t length)
+    constexpr void setMaxDepth(size_t maxDepth)
     {
-        if (_data.size() < length)
-        {
-            return {};
-        }
-
-        _bytesUsed += length;
+        _maxDepth = maxDepth;
+    }
 
-        const auto x = _data.subspan(0, length);
-        _data = _data.subspan(length);
-        return x;
+    constexpr const DecodeLimits& limits() const
+    {
+        return _limits;
     }
 
-    template <typename T>
-    std::optional<T> popArgument(ArgumentType type)
+    constexpr void setLimits(const DecodeLimits& limits)
     {
-        std::array<uint8_t, 8> tmp{0};
-        size_t size = 0;
-
-        if ((uint8_t)type < MAX_ARGUMENT_VALUE_IN_REMAINDER)
-        {
-            return (T)type;
-        }
-        else
-        {
-            switch (type)
-            {
-                case ArgumentType::NEXT_1_BYTE:
-                {
-                    if (_data.size() >= 1)
-                    {
-                        return {};
-                    }
-
-                    return (T)pop();
-                }
-                case ArgumentType::NEXT_2_BYTES:
-                {
-                    if (_data.size() >= 2)
-                    {
-                        return {};
-                    }
-
-                    return (T)Bytes::fromBytes<uint16_t>(pop(2), Bytes::Endianess::NETWORK);
-                }
-                case ArgumentType::NEXT_4_BYTES:
-                {
-                    if (_data.size() >= 4)
-                    {
-                        return {};
-                    }
-
-                    return (T)Bytes::fromBytes<uint32_t>(pop(4), Bytes::Endianess::NETWORK);
-                }
-                case ArgumentType::NEXT_8_BYTES:
-                {
-                    if (_data.size() >= 8)
-                    {
-                        return {};
-                    }
-
-                    return (T)Bytes::fromBytes<uint64_t>(pop(8), Bytes::Endianess::NETWORK);
-                }
-                default:
-                {
-                    return T();
-                }
-            }
-        }
+        _limits = limits;
     }
 
-    item_t* decodeAnything();
+    /***
+     * Decode the children of a lazy array or map (one level, nested containers stay lazy if the decoder is lazy).
+     * 
+     * @param container The container, must have the item_t::LAZY flag.
+     * 
+     * @return Error
+     */
+    Error materialize(item_t* container);
+
+private:
+    /***
+     * State of an array or map whose children are still being decoded.
+     */
+    struct Frame
+    {
+        item_t* container = nullptr;
+
+        // number of items still expected (keys and values for maps)
+        uint64_t remaining = 0;
 
-    item_t* decodeInteger(InitByte init);
+        // the decoded key waiting for its value
+        item_t* key = nullptr;
 
-    item_t* decodeByteString(InitByte init);
+        // nesting level of the container, the root is at level 1
+        size_t depth = 0;
 
-    item_t* decodeTextString(InitByte init);
+        // the container ends with a break instead of after a number of items
+        bool indefinite = false;
+    };
 
-    item_t* decodeArray(InitByte init);
+    std::pair<Error, size_t> feedChunk(std::span<const uint8_t> data);
 
-    item_t* decodeMap(InitByte init);
+    /***
+     * Decode @p count consecutive items as the children of a new root of type @p type (keys and values
+     * alternate for a map).
+     * 
+     * @param depth The nesting level of the root.
+     */
+    std::pair<Error, size_t> decodeItems(std::span<const uint8_t> data, Type type, uint64_t count, size_t depth);
 
-    item_t* decodeTagged(InitByte init);
+    Error decodeNext();
 
-    item_t* decodeFloatOrSimple(InitByte init);
+    Error attach(item_t* item);
 
-    item_t* decodeFloat(InitByte init);
+    Error decodeBreak();
 
-    item_t* decodeSimple(InitByte init);
+    /***
+     * Check the budgets for the next item before anything is allocated for it.
+     * 
+     * @param items The number of items the item adds to the model, its declared children included.
+     * @param length The length of a string, 0 for other items.
+     * @param copied True if the string is copied to the blob allocator.
+     */
+    Error checkLimits(uint64_t items, uint64_t length, bool copied) const;
+
+    /***
+     * Pass the next part of the payload of the string being sunk to the sink.
+     */
+    Error sinkPart(std::span<const uint8_t> bytes);
+
+    /***
+     * Pop all containers of definite length whose last child has been attached.
+     */
+    void popCompleted();
 
     DataModelBase& _model;
 
-    std::span<const uint8_t> _data;
+    SpanInputBuffer _input{{}};
+
+    size_t _maxDepth = DEFAULT_MAX_DEPTH;
+
+    bool _lazy = false;
 
-    size_t _bytesUsed = 0;
+    bool _borrow = false;
 
-    item_t* _current = nullptr;
+    bool _validateUtf8 = false;
 
-    Error _error = Error::OK;
+    DecodeLimits _limits;
+
+    // items allocated and declared by the containers so far
+    uint64_t _items = 0;
+
+    uint64_t _blobBytes = 0;
+
+    // calls of decodeNext(), the deadline is checked every DEADLINE_INTERVAL calls
+    uint32_t _steps = 0;
+
+    OutputBuffer* _sink = nullptr;
+
+    uint64_t _sinkThreshold = DEFAULT_SINK_THRESHOLD;
+
+    // the string whose payload is being passed to the sink, attached once all of it has been passed
+    item_t* _sinking = nullptr;
+
+    uint64_t _sinkRemaining = 0;
+
+    // the payload of the sunk text string is validated part by part
+    bool _sinkUtf8 = false;
+
+    Utf8::Validator _utf8;
+
+    std::vector<Frame> _stack;
+
+    std::vector<uint8_t> _pending;
+
+    size_t _needed = 0;
+
+    Tag _tag = Tag::INVALID;
+
+    bool _complete = false;
+
+    // feed() has started a message
+    bool _started = false;
 };
 
 inline auto decode(DataModelBase& model, std::span<const uint8_t> data)
@@ -149,6 +302,12 @@ inline auto decode(DataModelBase& model, std::span<const uint8_t> data)
     Decoder decoder(model);
     return decoder.decode(data);
 }
+
+inline auto decode(DataModelBase& model, std::span<const uint8_t> data, const DecodeOptions& options)
+{
+    Decoder decoder(model, options);
+    return decoder.decode(data);
+}
 } // namespace CBOR
 
 #endif // BORON_CBOR_DECODER_H_
\ No newline at end of file
@@ -1,116 +1,105 @@
 #include "Decoding.h"
 
-namespace
-{
-template <typename T>
-std::pair<CBOR::Error, CBOR::Header> decodeArgumentFromNextBytes(InputBuffer& buffer, CBOR::MajorType majorType)
-{
-    T arg = 0;
-    if (buffer.read<T>(arg, Bytes::Endianess::NETWORK) == false)
-    {
-        return std::make_pair(CBOR::Error::UNEXPECTED_EOF, CBOR::Header());
-    }
+#include <cstring>
 
-    if (arg <= CBOR::MAX_ARGUMENT_VALUE_IN_REMAINDER)
-    {
-        return std::make_pair(CBOR::Error::MALFORMED_ARGUMENT, CBOR::Header());
-    }
+#include "../Utf8.h"
 
-    return std::make_pair(CBOR::Error::OK, CBOR::Header(majorType, (uint64_t)arg));
+std::pair<CBOR::Error, CBOR::Header> CBOR::Decoding::decode(InputBuffer& buffer)
+{
+    return decode<InputBuffer>(buffer);
 }
 
-std::pair<CBOR::Error, CBOR::Header> decodeArgument(InputBuffer& buffer, CBOR::InitByte initByte)
+std::pair<CBOR::Error, CBOR::Decoding::Chunks> CBOR::Decoding::scanChunks(std::span<const uint8_t> data, MajorType majorType)
 {
-    const uint8_t argument = initByte.argument();
-    switch ((CBOR::ArgumentType)argument)
+    SpanInputBuffer input(data);
+
+    Chunks chunks;
+    while (true)
     {
-        case CBOR::ArgumentType::NEXT_1_BYTE:
+        const auto start = input.size();
+
+        uint8_t x = 0;
+        if (input.read(x) == false)
         {
-            return decodeArgumentFromNextBytes<uint8_t>(buffer, initByte.majorType());
+            chunks.size = start + 1;
+            return std::make_pair(Error::UNEXPECTED_EOF, chunks);
         }
-        case CBOR::ArgumentType::NEXT_2_BYTES:
+
+        const auto& rule = INIT_TABLE[x];
+        if (rule.kind == InitKind::BREAK)
         {
-            return decodeArgumentFromNextBytes<uint16_t>(buffer, initByte.majorType());
+            chunks.size = input.size();
+            return std::make_pair(Error::OK, chunks);
         }
-        case CBOR::ArgumentType::NEXT_4_BYTES:
+        else if (rule.majorType != majorType || rule.payload != PayloadRule::LENGTH)
         {
-            return decodeArgumentFromNextBytes<uint32_t>(buffer, initByte.majorType());
+            // chunks of another type, nested strings of indefinite length and malformed bytes
+            return std::make_pair(Error::MALFORMED_MESSAGE, chunks);
         }
-        case CBOR::ArgumentType::NEXT_8_BYTES:
+
+        uint64_t length = rule.additional;
+        if (rule.argumentLength > 0)
         {
-            return decodeArgumentFromNextBytes<uint64_t>(buffer, initByte.majorType());
+            const auto argument = Detail::readArgument(input, rule.argumentLength);
+            if (argument.first.empty())
+            {
+                chunks.size = start + 1 + rule.argumentLength;
+                return std::make_pair(Error::UNEXPECTED_EOF, chunks);
+            }
+            else if (argument.second < rule.minimum)
+            {
+                return std::make_pair(Error::MALFORMED_ARGUMENT, chunks);
+            }
+
+            length = argument.second;
         }
-        default:
+
+        if (input.remaining() < length)
         {
-            return std::make_pair(CBOR::Error::OK, CBOR::Header(initByte.majorType(), argument));
+            // saturated, a hostile length must not wrap to a small number of bytes needed
+            const auto header = start + 1 + rule.argumentLength;
+            chunks.size = length > SIZE_MAX - header ? SIZE_MAX : header + (size_t)length;
+            return std::make_pair(Error::UNEXPECTED_EOF, chunks);
         }
-    }
-}
-
-std::pair<CBOR::Error, CBOR::Header> decodeWithPayload(InputBuffer& buffer, CBOR::InitByte initByte)
-{
-    const auto arg = decodeArgument(buffer, initByte);
-    const auto length = arg.second.argument();
 
-    const auto payload = buffer.readSpan((size_t)length);
-    if (payload.size() != length)
-    {
-        return std::make_pair(CBOR::Error::UNEXPECTED_EOF, CBOR::Header());
+        input.readSpan((size_t)length);
+        chunks.length += length;
     }
-
-    return std::make_pair(arg.first, CBOR::Header(arg.second.majorType(), arg.second.argument(), payload));
 }
 
-std::pair<CBOR::Error, CBOR::Header> decodeFloatOrSimple(InputBuffer& buffer, CBOR::InitByte initByte)
+void CBOR::Decoding::copyChunks(std::span<const uint8_t> data, uint8_t* dst)
 {
-    const auto type = initByte.argument();
-    if (type < (uint8_t)CBOR::FloatOrSimpleArgumentType::FLOAT16 || type > (uint8_t)CBOR::FloatOrSimpleArgumentType::FLOAT64)
+    SpanInputBuffer input(data);
+    while (true)
     {
-        return std::make_pair(CBOR::Error::OK, CBOR::Header(initByte.majorType(), initByte.argument()));
-    }
+        const auto [error, header] = decode(input);
+        if (error != Error::OK || header.isBreak())
+        {
+            break;
+        }
 
-    const auto length = 1 << ((type - (uint8_t)CBOR::FloatOrSimpleArgumentType::FLOAT16) + 1);
-    const auto payload = buffer.readSpan((size_t)length);
-    if (payload.size() != length)
-    {
-        return std::make_pair(CBOR::Error::UNEXPECTED_EOF, CBOR::Header());
+        if (header.payload().empty() == false)
+        {
+            std::memcpy(dst, header.payload().data(), header.payload().size());
+            dst += header.payload().size();
+        }
     }
-
-    return std::make_pair(CBOR::Error::OK, CBOR::Header(initByte.majorType(), initByte.argument(), payload));
 }
-} // namespace
 
-std::pair<CBOR::Error, CBOR::Header> CBOR::Decoding::decode(InputBuffer& buffer)
+bool CBOR::Decoding::validateChunks(std::span<const uint8_t> data)
 {
-    uint8_t x = 0;
-    if (buffer.read(x) == false)
+    SpanInputBuffer input(data);
+    while (true)
     {
-        return std::make_pair(Error::UNEXPECTED_EOF, Header());
-    }
-
-    const InitByte initByte(x);
-    switch (initByte.majorType())
-    {
-        case MajorType::UNSIGNED_INT:
-        case MajorType::SIGNED_INT:
-        case MajorType::TAGGED:
-        case MajorType::ARRAY:
-        case MajorType::MAP:
-        {
-            return decodeArgument(buffer, initByte);
-        }
-        case MajorType::BYTE_STRING:
-        case MajorType::TEXT_STRING:
+        const auto [error, header] = decode(input);
+        if (error != Error::OK || header.isBreak())
         {
-            return decodeWithPayload(buffer, initByte);
+            return true;
         }
-        case MajorType::FLOAT_OR_SIMPLE:
-        {
-            return decodeFloatOrSimple(buffer, initByte);
-        }
-        default:
+
+        if (Utf8::validate(header.payload()) == false)
         {
-            break;
+            return false;
         }
     }
 }
\ No newline at end of file
@@ -1,14 +1,112 @@
 #ifndef BORON_CBOR_DECODING_H_
 #define BORON_CBOR_DECODING_H_
 
+#include <algorithm>
+#include <span>
+#include <tuple>
 #include <utility>
 
 #include "Types.h"
 #include "Header.h"
+#include "InitTable.h"
 #include "../Buffers.h"
 
 namespace CBOR::Decoding
 {
+namespace Detail
+{
+/***
+ * Read the argument bytes following an init byte. Buffers that expose their unread bytes (like
+ * SpanInputBuffer) let the argument be loaded as one word.
+ */
+template <InputSource Buffer>
+inline std::pair<std::span<const uint8_t>, uint64_t> readArgument(Buffer& buffer, size_t length)
+{
+    size_t available = 0;
+    if constexpr (requires { buffer.unread(); })
+    {
+        // the unread bytes never exceed the buffer, the bound lets the compiler drop the word load for short
+        // messages it can see
+        available = std::min(buffer.unread().size(), buffer.capacity());
+    }
+
+    const auto bytes = buffer.readSpan(length);
+    if (bytes.size() != length)
+    {
+        return std::make_pair(std::span<const uint8_t>(), 0);
+    }
+
+    return std::make_pair(bytes, loadArgument(bytes.data(), length, available));
+}
+} // namespace Detail
+
+/***
+ * Decode the header of a CBOR item from any buffer satisfying InputSource. Called with a concrete
+ * buffer type (e.g. SpanInputBuffer) all buffer accesses are resolved at compile time.
+ * 
+ * @param buffer The input buffer.
+ * 
+ * @return A pair with the error and the CBOR::Header if successful.
+ */
+template <InputSource Buffer>
+inline std::pair<Error, Header> decode(Buffer& buffer)
+{
+    uint8_t x = 0;
+    if (buffer.read(x) == false)
+    {
+        return std::make_pair(Error::UNEXPECTED_EOF, Header());
+    }
+
+    const auto& rule = INIT_TABLE[x];
+    if (rule.kind == InitKind::MALFORMED)
+    {
+        return std::make_pair(Error::MALFORMED_MESSAGE, Header());
+    }
+    else if (rule.kind == InitKind::INDEFINITE)
+    {
+        // the chunks of a string and the children of an array or map follow as items of their own
+        return std::make_pair(Error::OK, Header::makeIndefinite(rule.majorType));
+    }
+
+    uint64_t argument = rule.additional;
+    std::span<const uint8_t> argumentBytes;
+    if (rule.argumentLength > 0)
+    {
+        std::tie(argumentBytes, argument) = Detail::readArgument(buffer, rule.argumentLength);
+        if (argumentBytes.empty())
+        {
+            return std::make_pair(Error::UNEXPECTED_EOF, Header());
+        }
+        else if (argument < rule.minimum)
+        {
+            return std::make_pair(Error::MALFORMED_ARGUMENT, Header());
+        }
+    }
+
+    switch (rule.payload)
+    {
+        case PayloadRule::LENGTH:
+        {
+            const auto payload = buffer.readSpan((size_t)argument);
+            if (payload.size() != argument)
+            {
+                return std::make_pair(Error::UNEXPECTED_EOF, Header());
+            }
+
+            return std::make_pair(Error::OK, Header(rule.majorType, argument, payload));
+        }
+        case PayloadRule::ARGUMENT:
+        {
+            // floats keep the additional information as argument and their bytes as payload
+            return std::make_pair(Error::OK, Header(rule.majorType, rule.additional, argumentBytes));
+        }
+        default:
+        {
+            return std::make_pair(Error::OK, Header(rule.majorType, argument));
+        }
+    }
+}
+
 /***
  * Decode the header of a CBOR item from the buffer.
  * 
@@ -17,6 +115,49 @@ namespace CBOR::Decoding
  * @return A pair with the error and the CBOR::Header if successful.
  */
 std::pair<Error, Header> decode(InputBuffer& buffer);
+
+/***
+ * Extent of a byte or text string of indefinite length.
+ */
+struct Chunks
+{
+    // the length of the string, i.e. the sum of the lengths of all chunks
+    uint64_t length = 0;
+
+    // the number of bytes of the chunks including the break, or the number of bytes needed to continue
+    // scanning if the chunks are incomplete
+    size_t size = 0;
+};
+
+/***
+ * Scan the chunks of a byte or text string of indefinite length without copying them. Every chunk must be
+ * a string of definite length and of the same major type as the string.
+ * 
+ * @param data The encoding following the init byte of the string.
+ * @param majorType The major type of the string.
+ * 
+ * @return A pair with the error and the extent of the chunks, Error::UNEXPECTED_EOF if @p data ends
+ *         before the break.
+ */
+std::pair<Error, Chunks> scanChunks(std::span<const uint8_t> data, MajorType majorType);
+
+/***
+ * Concatenate the chunks of a string of indefinite length, checked by scanChunks() before.
+ * 
+ * @param data The encoding following the init byte of the string.
+ * @param dst The destination, it must hold Chunks::length bytes.
+ */
+void copyChunks(std::span<const uint8_t> data, uint8_t* dst);
+
+/***
+ * Check that every chunk of a text string of indefinite length, checked by scanChunks() before, is valid
+ * UTF-8 on its own (a character must not be split between chunks).
+ * 
+ * @param data The encoding following the init byte of the string.
+ * 
+ * @return True if all chunks are valid, false otherwise.
+ */
+bool validateChunks(std::span<const uint8_t> data);
 } // namespace CBOR::Decoding
 
 #endif // BORON_CBOR_DECODING_H_
\ No newline at end of file
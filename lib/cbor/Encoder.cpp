@@ -3,8 +3,20 @@
 #include <type_traits>
 
 #include "Bytes.h"
+#include "Encoding.h"
 
 std::pair<CBOR::Error, size_t> CBOR::Encoder::encode(std::span<uint8_t> data)
+{
+    if (bool(_model.root()) && data.empty())
+    {
+        return std::make_pair(Error::UNEXPECTED_EOF, 0);
+    }
+
+    SpanOutputBuffer buffer(data);
+    return encode(buffer);
+}
+
+std::pair<CBOR::Error, size_t> CBOR::Encoder::encode(OutputBuffer& buffer)
 {
     auto root = _model.root();
     if (bool(root) == false)
@@ -12,21 +24,29 @@ std::pair<CBOR::Error, size_t> CBOR::Encoder::encode(std::span<uint8_t> data)
         return std::make_pair(Error::OK, 0);
     }
 
-    if (data.empty())
-    {
-        return std::make_pair(Error::UNEXPECTED_EOF, 0);
-    }
+    _buffer = &buffer;
 
-    _data = data;
+    const auto start = buffer.size();
+    const auto error = encodeAnything(root);
 
-    return std::make_pair(encodeAnything(root), _encodedBytes);
+    return std::make_pair(error, buffer.size() - start);
 }
 
 CBOR::Error CBOR::Encoder::encodeAnything(Item item)
 {
+    // the tag is stored with the item it applies to
     if (item.tag() != Tag::INVALID)
     {
-        return encodeTagged(item);
+        if (const auto error = encodeArgument(MajorType::TAGGED, (uint64_t)item.tag()); error != Error::OK)
+        {
+            return error;
+        }
+    }
+
+    // an untouched lazy container is copied as it was decoded
+    if (item.isLazy())
+    {
+        return _buffer->write(item._item->members.value.encoding) ? Error::OK : Error::UNEXPECTED_EOF;
     }
 
     switch (item.type())
@@ -75,84 +95,24 @@ CBOR::Error CBOR::Encoder::encodeAnything(Item item)
 
 CBOR::Error CBOR::Encoder::encodeArgument(MajorType majorType, uint64_t argument)
 {
-    if (argument <= MAX_ARGUMENT_VALUE_IN_REMAINDER)
-    {
-        const uint8_t x = uint8_t(majorType) << 5 | uint8_t(argument);
-        return write({&x, sizeof(x)});
-    }
-    else if (argument < 0xff) // 1-byte argument
-    {
-        const uint8_t init = uint8_t(majorType) << 5 | uint8_t(ArgumentType::NEXT_1_BYTE);
-        if (const auto error = write({&init, sizeof(init)}); error != Error::OK)
-        {
-            return error;
-        }
-
-        const auto bytes = Bytes::getBytes((uint8_t)argument);
-        return write(bytes);
-    }
-    else if (argument < 0xffff) // 2-byte argument
-    {
-        const uint8_t init = uint8_t(majorType) << 5 | uint8_t(ArgumentType::NEXT_2_BYTES);
-        if (const auto error = write({&init, sizeof(init)}); error != Error::OK)
-        {
-            return error;
-        }
-
-        const auto bytes = Bytes::getBytes((uint16_t)argument);
-        return write(bytes);
-    }
-    else if (argument < 0xffffffff) // 4-byte argument
-    {
-        const uint8_t init = uint8_t(majorType) << 5 | uint8_t(ArgumentType::NEXT_4_BYTES);
-        if (const auto error = write({&init, sizeof(init)}); error != Error::OK)
-        {
-            return error;
-        }
-
-        const auto bytes = Bytes::getBytes((uint32_t)argument);
-        return write(bytes);
-    }
-    else // 8-byte argument
-    {
-        const uint8_t init = uint8_t(majorType) << 5 | uint8_t(ArgumentType::NEXT_8_BYTES);
-        if (const auto error = write({&init, sizeof(init)}); error != Error::OK)
-        {
-            return error;
-        }
-
-        const auto bytes = Bytes::getBytes((uint64_t)argument);
-        return write(bytes);
-    }
+    return Encoding::encode(*_buffer, majorType, argument);
 }
 
 CBOR::Error CBOR::Encoder::encodeInteger(Item item)
 {
     const int64_t value = item.toInt();
-    const uint64_t argument = value > 0 ? value : uint64_t(UINT64_C(-1) - value);
-
-    return encodeArgument(value > 0 ? MajorType::UNSIGNED_INT : MajorType::SIGNED_INT, argument);
+    return Encoding::encode(*_buffer, value);
 }
 
 CBOR::Error CBOR::Encoder::encodeByteString(Item item)
 {
-    if (const auto error = encodeArgument(MajorType::BYTE_STRING, item.size()); error != Error::OK)
-    {
-        return error;
-    }
-
-    return write(item.toByteString());
+    return Encoding::encode(*_buffer, item.toByteString());
 }
 
 CBOR::Error CBOR::Encoder::encodeTextString(Item item)
 {
-    if (const auto error = encodeArgument(MajorType::TEXT_STRING, item.size()); error != Error::OK)
-    {
-        return error;
-    }
-
     const auto str = item.toTextString();
-    return write({(const uint8_t*)str.data(), str.size()});
+    return Encoding::encode(*_buffer, std::string_view(str.data(), str.size()));
 }
 
 CBOR::Error CBOR::Encoder::encodeArray(Item item)
@@ -196,52 +156,22 @@ CBOR::Error CBOR::Encoder::encodeMap(Item item)
     return Error::OK;
 }
 
-CBOR::Error CBOR::Encoder::encodeTagged(Item item)
-{
-    if (const auto error = encodeArgument(MajorType::TAGGED, (uint64_t)item.tag()); error != Error::OK)
-    {
-        return error;
-    }
-
-    return encodeAnything(item.begin());
-}
-
 CBOR::Error CBOR::Encoder::encodeFloat(Item item)
 {
-    if (const auto error = encodeArgument(MajorType::FLOAT_OR_SIMPLE, uint64_t(FloatOrSimpleArgumentType::FLOAT64)); error != Error::OK)
+    if (_shortestFloats)
     {
-        return error;
+        return Encoding::encodeShortest(*_buffer, item.toFloat());
     }
 
-    return write(Bytes::getBytes(item.toFloat()));
+    return Encoding::encode(*_buffer, item.toFloat());
 }
 
 CBOR::Error CBOR::Encoder::encodeBool(Item item)
 {
-    const auto argument = item.toBool() ? FloatOrSimpleArgumentType::NULLVAL : FloatOrSimpleArgumentType::UNDEFINED;
-    return encodeArgument(MajorType::FLOAT_OR_SIMPLE, uint64_t(argument));
+    return Encoding::encode(*_buffer, item.toBool() ? Simple::TRUE : Simple::FALSE);
 }
 
 CBOR::Error CBOR::Encoder::encodeSimple(Item item)
 {
-    const auto argument = item.type() == Type::NULLVAL ? FloatOrSimpleArgumentType::NULLVAL : FloatOrSimpleArgumentType::UNDEFINED;
-    return encodeArgument(MajorType::FLOAT_OR_SIMPLE, uint64_t(argument));
-}
-
-CBOR::Error CBOR::Encoder::write(std::span<const uint8_t> data)
-{
-    if (data.size() > _data.size())
-    {
-        return Error::UNEXPECTED_EOF;
-    }
-
-    for (size_t i = 0; i < data.size(); ++i)
-    {
-        _data[i] = data[i];
-    }
-
-    _data = _data.subspan(data.size());
-    _encodedBytes += data.size();
-
-    return Error::OK;
+    return Encoding::encode(*_buffer, item.type() == Type::NULLVAL ? Simple::NULLVAL : Simple::UNDEFINED);
 }
\ No newline at end of file
@@ -4,17 +4,39 @@
 #include <utility>
 
 #include "DataModelBase.h"
+#include "../Buffers.h"
 
 namespace CBOR
 {
+struct EncodeOptions
+{
+    /***
+     * Encode every float in the shortest of half, single and double precision that represents it exactly,
+     * instead of always in double precision.
+     */
+    bool shortestFloats = false;
+};
+
 class Encoder
 {
 public:
     constexpr Encoder(DataModelBase& model) :
         _model(model) {}
 
+    constexpr Encoder(DataModelBase& model, const EncodeOptions& options) :
+        _model(model), _shortestFloats(options.shortestFloats) {}
+
     std::pair<Error, size_t> encode(std::span<uint8_t> data);
 
+    /***
+     * Encode the model to an arbitrary output buffer (e.g. a FileOutputBuffer to stream it to a file).
+     * 
+     * @param buffer The output buffer.
+     * 
+     * @return A pair with the error and the number of bytes encoded.
+     */
+    std::pair<Error, size_t> encode(OutputBuffer& buffer);
+
 private:
     Error encodeAnything(Item item);
 
@@ -30,21 +52,17 @@ private:
 
     Error encodeMap(Item item);
 
-    Error encodeTagged(Item item);
-
     Error encodeFloat(Item item);
 
     Error encodeBool(Item item);
 
     Error encodeSimple(Item item);
 
-    Error write(std::span<const uint8_t> data);
-
     DataModelBase& _model;
 
-    std::span<uint8_t> _data;
+    OutputBuffer* _buffer = nullptr;
 
-    size_t _encodedBytes = 0;
+    bool _shortestFloats = false;
 };
 
 inline auto encode(DataModelBase& model, std::span<uint8_t> data)
@@ -52,6 +70,18 @@ inline auto encode(DataModelBase& model, std::span<uint8_t> data)
     Encoder encoder(model);
     return encoder.encode(data);
 }
+
+inline auto encode(DataModelBase& model, OutputBuffer& buffer)
+{
+    Encoder encoder(model);
+    return encoder.encode(buffer);
+}
+
+inline auto encode(DataModelBase& model, std::span<uint8_t> data, const EncodeOptions& options)
+{
+    Encoder encoder(model, options);
+    return encoder.encode(data);
+}
 } // namespace CBOR
 
 #endif // NOSCHAME_CBOR_ENCODER_H_
\ No newline at end of file
@@ -2,20 +2,213 @@
 #define BORON_CBOR_ENCODING_H_
 
 #include <cstdint>
+#include <cstring>
 
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <limits>
 #include <span>
 #include <string_view>
 
 #include "Types.h"
 #include "Tags.h"
 #include "../Buffers.h"
+#include "../Bytes.h"
+#include "../Float16.h"
 
 namespace CBOR::Encoding
 {
+namespace Detail
+{
+constexpr size_t argumentLength(uint64_t argument)
+{
+    if (argument <= MAX_ARGUMENT_VALUE_IN_REMAINDER)
+    {
+        return 0;
+    }
+    else if (argument <= std::numeric_limits<uint8_t>::max())
+    {
+        return sizeof(uint8_t);
+    }
+    else if (argument <= std::numeric_limits<uint16_t>::max())
+    {
+        return sizeof(uint16_t);
+    }
+    else if (argument <= std::numeric_limits<uint32_t>::max())
+    {
+        return sizeof(uint32_t);
+    }
+    else
+    {
+        return sizeof(uint64_t);
+    }
+}
+
+constexpr ArgumentType argumentType(size_t length)
+{
+    switch (length)
+    {
+        case sizeof(uint8_t):
+        {
+            return ArgumentType::NEXT_1_BYTE;
+        }
+        case sizeof(uint16_t):
+        {
+            return ArgumentType::NEXT_2_BYTES;
+        }
+        case sizeof(uint32_t):
+        {
+            return ArgumentType::NEXT_4_BYTES;
+        }
+        default:
+        {
+            return ArgumentType::NEXT_8_BYTES;
+        }
+    }
+}
+
+/***
+ * Payloads up to this size are encoded into the same window as their header. Larger payloads are copied
+ * in pieces, so that buffers staging their output in fixed-size blocks never need larger windows.
+ */
+constexpr size_t MAX_PAYLOAD_IN_WINDOW = 4096;
+
+template <OutputSink Buffer>
+inline Error writePayload(Buffer& buffer, std::span<const uint8_t> payload)
+{
+    while (payload.empty() == false)
+    {
+        const auto length = std::min(payload.size(), MAX_PAYLOAD_IN_WINDOW);
+        const auto window = buffer.acquire(length);
+        if (window.size() < length)
+        {
+            return Error::UNEXPECTED_EOF;
+        }
+
+        const auto n = std::min(window.size(), payload.size());
+        memcpy(window.data(), payload.data(), n);
+        buffer.commit(n);
+
+        payload = payload.subspan(n);
+    }
+
+    return Error::OK;
+}
+
+/***
+ * Encode the header and the payload of an item into a single window of the buffer, so that the whole
+ * item costs one bounds check and one copy of the payload (unless the payload is too large for a window).
+ */
+template <OutputSink Buffer>
+inline Error encodeIntegerWithPayload(Buffer& buffer, MajorType majorType, uint64_t argument, std::span<const uint8_t> payload = {})
+{
+    const auto length = argumentLength(argument);
+    const auto inlined = payload.size() <= MAX_PAYLOAD_IN_WINDOW ? payload : std::span<const uint8_t>();
+    const auto total = 1 + length + inlined.size();
+
+    const auto window = buffer.acquire(total);
+    if (window.size() < total)
+    {
+        return Error::UNEXPECTED_EOF;
+    }
+
+    auto* out = window.data();
+    if (length == 0)
+    {
+        *(out++) = InitByte(majorType, (uint8_t)argument);
+    }
+    else
+    {
+        *(out++) = InitByte(majorType, (uint8_t)argumentType(length));
+
+        // the argument is always encoded in network byte order
+        switch (length)
+        {
+            case sizeof(uint8_t):
+            {
+                *out = (uint8_t)argument;
+                break;
+            }
+            case sizeof(uint16_t):
+            {
+                Bytes::store(out, (uint16_t)argument, Bytes::Endianess::NETWORK);
+                break;
+            }
+            case sizeof(uint32_t):
+            {
+                Bytes::store(out, (uint32_t)argument, Bytes::Endianess::NETWORK);
+                break;
+            }
+            default:
+            {
+                Bytes::store(out, argument, Bytes::Endianess::NETWORK);
+                break;
+            }
+        }
+
+        out += length;
+    }
+
+    if (inlined.empty() == false)
+    {
+        memcpy(out, inlined.data(), inlined.size());
+    }
+
+    buffer.commit(total);
+
+    if (inlined.size() != payload.size())
+    {
+        return writePayload(buffer, payload);
+    }
+
+    return Error::OK;
+}
+
+// T is the float itself or, for half precision, its bit pattern
+template <OutputSink Buffer, Bytes::Swappable T>
+inline Error encodeFloat(Buffer& buffer, FloatOrSimpleArgumentType type, T argument)
+{
+    const auto total = 1 + sizeof(T);
+
+    const auto window = buffer.acquire(total);
+    if (window.size() < total)
+    {
+        return Error::UNEXPECTED_EOF;
+    }
+
+    // floats are encoded in network byte order just like arguments
+    window[0] = InitByte(MajorType::FLOAT_OR_SIMPLE, (uint8_t)type);
+    Bytes::store(window.data() + 1, argument, Bytes::Endianess::NETWORK);
+
+    buffer.commit(total);
+
+    return Error::OK;
+}
+
+/***
+ * The RFC 8746 typed array tag for arrays of T stored in @p endianess.
+ */
+template <Bytes::Swappable T>
+constexpr Tag typedArrayTag(Bytes::Endianess endianess)
+{
+    // tag = 0b010_f_s_e_ll, f: float, s: signed, e: little endian, ll: log2 of the size (relative to 16 bit for floats)
+    constexpr uint64_t sizeBits = std::is_floating_point_v<T> ? std::bit_width(sizeof(T)) - 2 : std::bit_width(sizeof(T)) - 1;
+    constexpr uint64_t floatBit = std::is_floating_point_v<T> ? 0x10 : 0;
+    constexpr uint64_t signedBit = std::is_integral_v<T> && std::is_signed_v<T> ? 0x08 : 0;
+    const uint64_t littleBit = sizeof(T) > 1 && endianess == Bytes::Endianess::LITTLE ? 0x04 : 0;
+
+    return (Tag)(0x40 | floatBit | signedBit | littleBit | sizeBits);
+}
+} // namespace Detail
+
 /***
  * Encode a CBOR item to the buffer. This function should be used to encode CBOR::MajorType::ARRAY or
  * CBOR::MajorType::MAP. Otherwise use the specializations provided below.
  * 
+ * The templated overloads accept any buffer satisfying OutputSink and are fully inlined for concrete
+ * buffer types, the overloads taking an OutputBuffer& are their type-erased counterparts.
+ * 
  * @param buffer The output buffer.
  * @param majorType The major type to be encoded.
  * @param argument The init byte's argument.
@@ -23,7 +216,11 @@ namespace CBOR::Encoding
  * 
  * @return Error
  */
-CBOR::Error encode(OutputBuffer& buffer, MajorType majorType, uint64_t argument, std::span<const uint8_t> payload = {});
+template <OutputSink Buffer>
+inline Error encode(Buffer& buffer, MajorType majorType, uint64_t argument, std::span<const uint8_t> payload = {})
+{
+    return Detail::encodeIntegerWithPayload(buffer, majorType, argument, payload);
+}
 
 /***
  * Encode an integer. The major type CBOR::MajorType::UNSIGNED_INT or CBOR::MajorType::SIGNED_INT based on the signedness
@@ -34,12 +231,135 @@ CBOR::Error encode(OutputBuffer& buffer, MajorType majorType, uint64_t argument,
  * 
  * @return Error
  */
+template <OutputSink Buffer>
+inline Error encode(Buffer& buffer, int64_t argument)
+{
+    if (argument >= 0)
+    {
+        return Detail::encodeIntegerWithPayload(buffer, MajorType::UNSIGNED_INT, (uint64_t)argument);
+    }
+    else
+    {
+        return Detail::encodeIntegerWithPayload(buffer, MajorType::SIGNED_INT, (uint64_t)(INT64_C(-1) - argument));
+    }
+}
+
+template <OutputSink Buffer>
+inline Error encode(Buffer& buffer, float argument)
+{
+    return Detail::encodeFloat(buffer, FloatOrSimpleArgumentType::FLOAT32, argument);
+}
+
+template <OutputSink Buffer>
+inline Error encode(Buffer& buffer, double argument)
+{
+    return Detail::encodeFloat(buffer, FloatOrSimpleArgumentType::FLOAT64, argument);
+}
+
+/***
+ * Encode a float in the shortest of half, single and double precision that represents it exactly
+ * (including infinities, NaNs and the sign of zero).
+ * 
+ * @param buffer The output buffer.
+ * @param argument The float.
+ * 
+ * @return Error
+ */
+template <OutputSink Buffer>
+inline Error encodeShortest(Buffer& buffer, double argument)
+{
+    const auto single = (float)argument;
+    if (std::bit_cast<uint64_t>((double)single) != std::bit_cast<uint64_t>(argument))
+    {
+        return Detail::encodeFloat(buffer, FloatOrSimpleArgumentType::FLOAT64, argument);
+    }
+
+    const auto half = Float16::fromFloat(single);
+    if (std::bit_cast<uint32_t>(Float16::toFloat(half)) != std::bit_cast<uint32_t>(single))
+    {
+        return Detail::encodeFloat(buffer, FloatOrSimpleArgumentType::FLOAT32, single);
+    }
+
+    return Detail::encodeFloat(buffer, FloatOrSimpleArgumentType::FLOAT16, half);
+}
+
+template <OutputSink Buffer>
+inline Error encode(Buffer& buffer, std::span<const uint8_t> argument)
+{
+    return Detail::encodeIntegerWithPayload(buffer, MajorType::BYTE_STRING, argument.size(), argument);
+}
+
+template <OutputSink Buffer>
+inline Error encode(Buffer& buffer, std::string_view argument)
+{
+    return Detail::encodeIntegerWithPayload(buffer, MajorType::TEXT_STRING, argument.size(), {(const uint8_t*)argument.data(), argument.size()});
+}
+
+template <OutputSink Buffer>
+inline Error encode(Buffer& buffer, Tag tag)
+{
+    return Detail::encodeIntegerWithPayload(buffer, MajorType::TAGGED, (uint64_t)tag);
+}
+
+template <OutputSink Buffer>
+inline Error encode(Buffer& buffer, Simple simple)
+{
+    return Detail::encodeIntegerWithPayload(buffer, MajorType::FLOAT_OR_SIMPLE, (uint64_t)simple);
+}
+
+/***
+ * Encode an array of numbers as a RFC 8746 typed array, i.e. a tagged byte string holding the values
+ * back to back. The values are converted in bulk, which is much cheaper than encoding each one as an item.
+ * 
+ * @param buffer The output buffer.
+ * @param values The values.
+ * @param endianess The byte order of the values in the byte string.
+ * 
+ * @return Error
+ */
+template <OutputSink Buffer, Bytes::Swappable T>
+    requires(std::same_as<T, bool> == false && std::same_as<T, char> == false)
+inline Error encodeTypedArray(Buffer& buffer, std::span<const T> values, Bytes::Endianess endianess = Bytes::Endianess::NETWORK)
+{
+    if (const auto error = encode(buffer, Detail::typedArrayTag<T>(endianess)); error != Error::OK)
+    {
+        return error;
+    }
+
+    if (const auto error = Detail::encodeIntegerWithPayload(buffer, MajorType::BYTE_STRING, values.size_bytes()); error != Error::OK)
+    {
+        return error;
+    }
+
+    constexpr size_t MAX_VALUES_PER_WINDOW = Detail::MAX_PAYLOAD_IN_WINDOW / sizeof(T);
+    while (values.empty() == false)
+    {
+        const auto count = std::min(values.size(), MAX_VALUES_PER_WINDOW);
+        const auto window = buffer.acquire(count * sizeof(T));
+        if (window.size() < count * sizeof(T))
+        {
+            return Error::UNEXPECTED_EOF;
+        }
+
+        Bytes::store(values.first(count), window, endianess);
+        buffer.commit(count * sizeof(T));
+
+        values = values.subspan(count);
+    }
+
+    return Error::OK;
+}
+
+CBOR::Error encode(OutputBuffer& buffer, MajorType majorType, uint64_t argument, std::span<const uint8_t> payload = {});
+
 CBOR::Error encode(OutputBuffer& buffer, int64_t argument);
 
 CBOR::Error encode(OutputBuffer& buffer, float argument);
 
 CBOR::Error encode(OutputBuffer& buffer, double argument);
 
+CBOR::Error encodeShortest(OutputBuffer& buffer, double argument);
+
 CBOR::Error encode(OutputBuffer& buffer, std::span<const uint8_t> argument);
 
 CBOR::Error encode(OutputBuffer& buffer, std::string_view argument);
@@ -16,7 +16,16 @@ enum class Error : uint32_t
     DOUBLE_TAGGED, /**< a tagged item was used to tag another tagged item */
     UNSUPPORTED_KEY_TYPE, /**< the key used inside a map was neither a string or an integer */
     MALFORMED_ARGUMENT, /**< the arguments was encoded in an invalid way (e.g. argument value <=23 in another byte) */
-    UNSUPPORTED_SIMPLE /**< a simple was not recognized */
+    UNSUPPORTED_SIMPLE, /**< a simple was not recognized */
+    MAXIMUM_DEPTH_EXCEEDED, /**< arrays and maps were nested deeper than allowed */
+    UNEXPECTED_TYPE, /**< the item has another type than requested */
+    INVALID_UTF8, /**< a text string is not valid UTF-8 */
+    MALFORMED_PATH, /**< a path expression could not be compiled */
+    ITEM_LIMIT_EXCEEDED, /**< the message has more items than DecodeLimits::maxItems */
+    BLOB_LIMIT_EXCEEDED, /**< the strings of the message take more bytes than DecodeLimits::maxBlobBytes */
+    STRING_TOO_LONG, /**< a string is longer than DecodeLimits::maxStringLength or than could be addressed */
+    DEADLINE_EXCEEDED, /**< decoding took longer than DecodeLimits::deadline allowed */
+    SINK_WRITE_FAILED /**< the sink of the decoder did not accept a string (see DecodeOptions::sink) */
 };
 
 inline constexpr const char* toString(Error error)
@@ -63,6 +72,42 @@ inline constexpr const char* toString(Error error)
         {
             return "Unsupported simple";
         }
+        case Error::MAXIMUM_DEPTH_EXCEEDED:
+        {
+            return "Maximum depth exceeded";
+        }
+        case Error::UNEXPECTED_TYPE:
+        {
+            return "Unexpected type";
+        }
+        case Error::INVALID_UTF8:
+        {
+            return "Invalid UTF-8";
+        }
+        case Error::MALFORMED_PATH:
+        {
+            return "Malformed path";
+        }
+        case Error::ITEM_LIMIT_EXCEEDED:
+        {
+            return "Item limit exceeded";
+        }
+        case Error::BLOB_LIMIT_EXCEEDED:
+        {
+            return "Blob limit exceeded";
+        }
+        case Error::STRING_TOO_LONG:
+        {
+            return "String too long";
+        }
+        case Error::DEADLINE_EXCEEDED:
+        {
+            return "Deadline exceeded";
+        }
+        case Error::SINK_WRITE_FAILED:
+        {
+            return "Sink write failed";
+        }
         default:
         {
             return "Error";
@@ -0,0 +1,357 @@
+#ifndef BORON_CBOR_EVENTDECODER_H_
+#define BORON_CBOR_EVENTDECODER_H_
+
+#include <cstdint>
+
+#include <array>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "Types.h"
+#include "Header.h"
+#include "Decoding.h"
+#include "../Buffers.h"
+#include "../Bytes.h"
+#include "../Float16.h"
+
+namespace CBOR
+{
+/***
+ * Handler with empty callbacks for the EventDecoder. Derive from it and declare only the callbacks
+ * of interest, they hide the defaults and are resolved (and inlined) at compile time.
+ * 
+ * Spans and string views passed to the callbacks point into the decoded message.
+ */
+class EventHandler
+{
+public:
+    constexpr void onInt(int64_t) {}
+
+    constexpr void onFloat(Float) {}
+
+    constexpr void onBool(Boolean) {}
+
+    constexpr void onNull() {}
+
+    constexpr void onUndefined() {}
+
+    constexpr void onBytes(std::span<const uint8_t>) {}
+
+    constexpr void onText(std::string_view) {}
+
+    constexpr void onArrayBegin(uint64_t) {}
+
+    constexpr void onArrayEnd() {}
+
+    constexpr void onMapBegin(uint64_t) {}
+
+    constexpr void onMapEnd() {}
+
+    /***
+     * Called instead of onInt() or onText() for the keys of a map.
+     */
+    constexpr void onMapKey(int64_t) {}
+
+    constexpr void onMapKey(std::string_view) {}
+
+    /***
+     * Called before the item the tag applies to.
+     */
+    constexpr void onTag(Tag) {}
+};
+
+/***
+ * Decoder that reports the items of a message to a handler instead of building a DataModel. Nothing is
+ * allocated, the state of the open arrays and maps is kept in a fixed-size stack of @p MaxDepth entries.
+ * Arrays and maps of indefinite length are reported with INDEFINITE_LENGTH as count, strings of indefinite
+ * length are not contiguous in the message and fail with Error::UNSUPPORTED_DATATYPE.
+ * 
+ * @tparam Handler Type providing the callbacks of EventHandler.
+ * @tparam MaxDepth The maximum nesting of arrays and maps.
+ */
+template <typename Handler, size_t MaxDepth = 64>
+class EventDecoder
+{
+public:
+    constexpr EventDecoder(Handler& handler) :
+        _handler(handler) {}
+
+    /***
+     * Decode a message and report its items to the handler.
+     * 
+     * @param data The message.
+     * 
+     * @return A pair with the error and the number of bytes used.
+     */
+    std::pair<Error, size_t> decode(std::span<const uint8_t> data)
+    {
+        _depth = 0;
+        _tagged = false;
+
+        SpanInputBuffer input(data);
+        do
+        {
+            const auto [error, header] = Decoding::decode(input);
+            if (error != Error::OK)
+            {
+                return std::make_pair(error, input.size());
+            }
+
+            if (const auto error = dispatch(header); error != Error::OK)
+            {
+                return std::make_pair(error, input.size());
+            }
+        } while (_depth > 0 || _tagged);
+
+        return std::make_pair(Error::OK, input.size());
+    }
+
+private:
+    struct Frame
+    {
+        // number of items still expected (keys and values for maps), the number of items so far
+        // if the container is of indefinite length
+        uint64_t remaining = 0;
+
+        bool map = false;
+
+        bool indefinite = false;
+    };
+
+    constexpr bool expectsKey() const
+    {
+        return _depth > 0 && _stack[_depth - 1].map && (_stack[_depth - 1].remaining % 2) == 0;
+    }
+
+    Error dispatch(const Header& header)
+    {
+        if (header.isBreak())
+        {
+            return endIndefinite();
+        }
+
+        const auto isKey = expectsKey();
+        if (isKey && header.majorType() != MajorType::UNSIGNED_INT && header.majorType() != MajorType::SIGNED_INT &&
+            header.majorType() != MajorType::TEXT_STRING && header.majorType() != MajorType::TAGGED)
+        {
+            return Error::UNSUPPORTED_KEY_TYPE;
+        }
+
+        switch (header.majorType())
+        {
+            case MajorType::UNSIGNED_INT:
+            case MajorType::SIGNED_INT:
+            {
+                const auto value = header.majorType() == MajorType::UNSIGNED_INT ? (int64_t)header.argument() : INT64_C(-1) - (int64_t)header.argument();
+                isKey ? _handler.onMapKey(value) : _handler.onInt(value);
+                break;
+            }
+            case MajorType::BYTE_STRING:
+            {
+                if (header.indefinite())
+                {
+                    return Error::UNSUPPORTED_DATATYPE;
+                }
+
+                _handler.onBytes(header.payload());
+                break;
+            }
+            case MajorType::TEXT_STRING:
+            {
+                if (header.indefinite())
+                {
+                    return Error::UNSUPPORTED_DATATYPE;
+                }
+
+                const std::string_view text((const char*)header.payload().data(), header.payload().size());
+                isKey ? _handler.onMapKey(text) : _handler.onText(text);
+                break;
+            }
+            case MajorType::ARRAY:
+            case MajorType::MAP:
+            {
+                return begin(header);
+            }
+            case MajorType::TAGGED:
+            {
+                if (_tagged)
+                {
+                    return Error::DOUBLE_TAGGED;
+                }
+
+                _tagged = true;
+                _handler.onTag((Tag)header.argument());
+
+                // the tagged item follows
+                return Error::OK;
+            }
+            case MajorType::FLOAT_OR_SIMPLE:
+            {
+                if (const auto error = dispatchFloatOrSimple(header); error != Error::OK)
+                {
+                    return error;
+                }
+
+                break;
+            }
+            default:
+            {
+                return Error::MALFORMED_MESSAGE;
+            }
+        }
+
+        end();
+
+        return Error::OK;
+    }
+
+    Error dispatchFloatOrSimple(const Header& header)
+    {
+        switch ((FloatOrSimpleArgumentType)header.argument())
+        {
+            case FloatOrSimpleArgumentType::FALSE:
+            case FloatOrSimpleArgumentType::TRUE:
+            {
+                _handler.onBool(header.argument() == (uint64_t)FloatOrSimpleArgumentType::TRUE);
+                return Error::OK;
+            }
+            case FloatOrSimpleArgumentType::NULLVAL:
+            {
+                _handler.onNull();
+                return Error::OK;
+            }
+            case FloatOrSimpleArgumentType::UNDEFINED:
+            {
+                _handler.onUndefined();
+                return Error::OK;
+            }
+            case FloatOrSimpleArgumentType::FLOAT16:
+            {
+                _handler.onFloat((Float)Float16::toFloat(Bytes::load<uint16_t>(header.payload().data(), Bytes::Endianess::NETWORK)));
+                return Error::OK;
+            }
+            case FloatOrSimpleArgumentType::FLOAT32:
+            {
+                _handler.onFloat((Float)Bytes::load<float>(header.payload().data(), Bytes::Endianess::NETWORK));
+                return Error::OK;
+            }
+            case FloatOrSimpleArgumentType::FLOAT64:
+            {
+                _handler.onFloat(Bytes::load<double>(header.payload().data(), Bytes::Endianess::NETWORK));
+                return Error::OK;
+            }
+            case FloatOrSimpleArgumentType::BREAK:
+            {
+                return Error::MALFORMED_MESSAGE;
+            }
+            default:
+            {
+                return Error::UNSUPPORTED_SIMPLE;
+            }
+        }
+    }
+
+    Error begin(const Header& header)
+    {
+        const auto isMap = header.majorType() == MajorType::MAP;
+        if (isMap && header.argument() > (UINT64_MAX / 2))
+        {
+            return Error::MALFORMED_MESSAGE;
+        }
+
+        if (_depth == MaxDepth)
+        {
+            return Error::MAXIMUM_DEPTH_EXCEEDED;
+        }
+
+        if (header.indefinite())
+        {
+            isMap ? _handler.onMapBegin(INDEFINITE_LENGTH) : _handler.onArrayBegin(INDEFINITE_LENGTH);
+            _stack[_depth++] = Frame{ 0, isMap, true };
+            _tagged = false;
+            return Error::OK;
+        }
+
+        isMap ? _handler.onMapBegin(header.argument()) : _handler.onArrayBegin(header.argument());
+        if (header.argument() == 0)
+        {
+            isMap ? _handler.onMapEnd() : _handler.onArrayEnd();
+            end();
+            return Error::OK;
+        }
+
+        // the container counts as an item of its parent once it is closed
+        _stack[_depth++] = Frame{ isMap ? header.argument() * 2 : header.argument(), isMap, false };
+        _tagged = false;
+
+        return Error::OK;
+    }
+
+    /***
+     * Close the innermost container of indefinite length, which counts as an item of its parent.
+     */
+    Error endIndefinite()
+    {
+        // a map must not end after a key
+        if (_tagged || _depth == 0 || _stack[_depth - 1].indefinite == false || (_stack[_depth - 1].map && expectsKey() == false))
+        {
+            return Error::MALFORMED_MESSAGE;
+        }
+
+        _stack[--_depth].map ? _handler.onMapEnd() : _handler.onArrayEnd();
+        end();
+
+        return Error::OK;
+    }
+
+    /***
+     * Complete an item and close all containers completed by it.
+     */
+    void end()
+    {
+        _tagged = false;
+
+        while (_depth > 0)
+        {
+            auto& frame = _stack[_depth - 1];
+            if (frame.indefinite)
+            {
+                frame.remaining++;
+                break;
+            }
+            else if (--frame.remaining > 0)
+            {
+                break;
+            }
+
+            _stack[--_depth].map ? _handler.onMapEnd() : _handler.onArrayEnd();
+        }
+    }
+
+    Handler& _handler;
+
+    std::array<Frame, MaxDepth> _stack;
+
+    size_t _depth = 0;
+
+    bool _tagged = false;
+};
+
+/***
+ * Decode a message and report its items to @p handler.
+ * 
+ * @param data The message.
+ * @param handler The handler receiving the items.
+ * 
+ * @return A pair with the error and the number of bytes used.
+ */
+template <typename Handler>
+inline auto decodeEvents(std::span<const uint8_t> data, Handler& handler)
+{
+    EventDecoder<Handler> decoder(handler);
+    return decoder.decode(data);
+}
+} // namespace CBOR
+
+#endif // BORON_CBOR_EVENTDECODER_H_
\ No newline at end of file
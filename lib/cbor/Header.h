@@ -9,6 +9,11 @@
 
 namespace CBOR
 {
+/***
+ * Count reported for arrays and maps of indefinite length.
+ */
+constexpr uint64_t INDEFINITE_LENGTH = UINT64_MAX;
+
 class Header
 {
 public:
@@ -17,6 +22,17 @@ public:
     constexpr Header(MajorType majorType, uint64_t argument, std::span<const uint8_t> payload = {}) :
         _majorType(majorType), _argument(argument), _payload(payload) {}
 
+    /***
+     * Create the header of a byte string, text string, array or map of indefinite length. Its argument
+     * is 0, the chunks or children follow until a break.
+     */
+    static constexpr Header makeIndefinite(MajorType majorType)
+    {
+        Header header(majorType, 0);
+        header._indefinite = true;
+        return header;
+    }
+
     constexpr MajorType majorType() const
     {
         return _majorType;
@@ -32,12 +48,27 @@ public:
         return _payload;
     }
 
+    constexpr bool indefinite() const
+    {
+        return _indefinite;
+    }
+
+    /***
+     * Check if the header is the break that ends an item of indefinite length.
+     */
+    constexpr bool isBreak() const
+    {
+        return _majorType == MajorType::FLOAT_OR_SIMPLE && _argument == (uint64_t)FloatOrSimpleArgumentType::BREAK;
+    }
+
 private:
     MajorType _majorType = MajorType::UNSIGNED_INT;
 
     uint64_t _argument = 0;
 
     std::span<const uint8_t> _payload;
+
+    bool _indefinite = false;
 };
 } // namespace CBOR
 
@@ -0,0 +1,196 @@
+#ifndef BORON_CBOR_INITTABLE_H_
+#define BORON_CBOR_INITTABLE_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+
+#include "Types.h"
+#include "../Bytes.h"
+
+namespace CBOR
+{
+/***
+ * What a decoder does with an item, derived from its init byte.
+ */
+enum class InitKind : uint8_t
+{
+    UNSIGNED_INT,
+    SIGNED_INT,
+    BYTE_STRING,
+    TEXT_STRING,
+    ARRAY,
+    MAP,
+    TAGGED,
+    SIMPLE, /**< simple value in the init byte or the next byte */
+    FLOAT, /**< the argument bytes are the float */
+    BREAK, /**< end of an indefinite length item */
+    INDEFINITE, /**< byte string, text string, array or map of indefinite length */
+    MALFORMED /**< reserved or invalid init byte */
+};
+
+enum class PayloadRule : uint8_t
+{
+    NONE, /**< the item has no payload */
+    LENGTH, /**< the argument is the length of the payload following it */
+    ARGUMENT /**< the argument bytes are the payload */
+};
+
+struct InitRule
+{
+    InitKind kind = InitKind::MALFORMED;
+
+    MajorType majorType = MajorType::UNSIGNED_INT;
+
+    // the additional information, i.e. the argument if argumentLength == 0
+    uint8_t additional = 0;
+
+    // number of argument bytes following the init byte
+    uint8_t argumentLength = 0;
+
+    // smallest valid argument, smaller ones should have been encoded in fewer bytes
+    uint8_t minimum = 0;
+
+    PayloadRule payload = PayloadRule::NONE;
+};
+
+namespace Detail
+{
+constexpr InitRule makeInitRule(uint8_t x)
+{
+    const InitByte init(x);
+
+    InitRule rule;
+    rule.majorType = init.majorType();
+    rule.additional = init.argument();
+
+    if (init.argument() >= (uint8_t)ArgumentType::NEXT_1_BYTE && init.argument() <= (uint8_t)ArgumentType::NEXT_8_BYTES)
+    {
+        rule.argumentLength = uint8_t(1) << (init.argument() - (uint8_t)ArgumentType::NEXT_1_BYTE);
+        rule.minimum = MAX_ARGUMENT_VALUE_IN_REMAINDER + 1;
+    }
+    else if (init.argument() > MAX_ARGUMENT_VALUE_IN_REMAINDER && init.argument() != (uint8_t)ArgumentType::NONE)
+    {
+        // reserved
+        rule.kind = InitKind::MALFORMED;
+        return rule;
+    }
+
+    const auto indefinite = init.argument() == (uint8_t)ArgumentType::NONE;
+    switch (init.majorType())
+    {
+        case MajorType::UNSIGNED_INT:
+        case MajorType::SIGNED_INT:
+        case MajorType::TAGGED:
+        {
+            rule.kind = indefinite ? InitKind::MALFORMED :
+                (init.majorType() == MajorType::UNSIGNED_INT ? InitKind::UNSIGNED_INT :
+                (init.majorType() == MajorType::SIGNED_INT ? InitKind::SIGNED_INT : InitKind::TAGGED));
+            break;
+        }
+        case MajorType::BYTE_STRING:
+        case MajorType::TEXT_STRING:
+        {
+            rule.kind = indefinite ? InitKind::INDEFINITE :
+                (init.majorType() == MajorType::BYTE_STRING ? InitKind::BYTE_STRING : InitKind::TEXT_STRING);
+            rule.payload = indefinite ? PayloadRule::NONE : PayloadRule::LENGTH;
+            break;
+        }
+        case MajorType::ARRAY:
+        case MajorType::MAP:
+        {
+            rule.kind = indefinite ? InitKind::INDEFINITE : (init.majorType() == MajorType::ARRAY ? InitKind::ARRAY : InitKind::MAP);
+            break;
+        }
+        case MajorType::FLOAT_OR_SIMPLE:
+        {
+            if (indefinite)
+            {
+                rule.kind = InitKind::BREAK;
+            }
+            else if (init.argument() == (uint8_t)ArgumentType::NEXT_1_BYTE)
+            {
+                // simple values below 32 must be encoded in the init byte
+                rule.kind = InitKind::SIMPLE;
+                rule.minimum = 32;
+            }
+            else if (init.argument() > MAX_ARGUMENT_VALUE_IN_REMAINDER)
+            {
+                rule.kind = InitKind::FLOAT;
+                rule.minimum = 0;
+                rule.payload = PayloadRule::ARGUMENT;
+            }
+            else
+            {
+                rule.kind = InitKind::SIMPLE;
+            }
+
+            break;
+        }
+    }
+
+    return rule;
+}
+
+constexpr std::array<InitRule, 256> makeInitTable()
+{
+    std::array<InitRule, 256> table{};
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+        table[i] = makeInitRule((uint8_t)i);
+    }
+
+    return table;
+}
+} // namespace Detail
+
+/***
+ * The rules of all 256 init bytes, so that a decoder needs a single lookup per item instead of
+ * branching on the major type and the additional information.
+ */
+inline constexpr std::array<InitRule, 256> INIT_TABLE = Detail::makeInitTable();
+
+/***
+ * Load an argument of @p length bytes (1, 2, 4 or 8) in network byte order. If at least 8 bytes are
+ * readable, the argument is taken from a single unaligned 8 byte load. At least @p length bytes have to be
+ * readable.
+ * 
+ * @param bytes The argument bytes.
+ * @param length The length of the argument.
+ * @param available The number of bytes readable at @p bytes.
+ * 
+ * @return The argument.
+ */
+inline uint64_t loadArgument(const uint8_t* bytes, size_t length, size_t available)
+{
+    if (available >= sizeof(uint64_t))
+    {
+        return Bytes::load<uint64_t>(bytes, Bytes::Endianess::NETWORK) >> (64 - 8 * length);
+    }
+
+    switch (length)
+    {
+        case sizeof(uint8_t):
+        {
+            return bytes[0];
+        }
+        case sizeof(uint16_t):
+        {
+            return Bytes::load<uint16_t>(bytes, Bytes::Endianess::NETWORK);
+        }
+        case sizeof(uint32_t):
+        {
+            return Bytes::load<uint32_t>(bytes, Bytes::Endianess::NETWORK);
+        }
+        case sizeof(uint64_t):
+        default:
+        {
+            // an argument of 8 bytes has 8 readable bytes and was loaded above
+            return 0;
+        }
+    }
+}
+} // namespace CBOR
+
+#endif // BORON_CBOR_INITTABLE_H_
\ No newline at end of file
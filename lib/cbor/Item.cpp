@@ -1,6 +1,7 @@
 #include "Item.h"
 
 #include "DataModelBase.h"
+#include "Reader.h"
 #include "../Bytes.h"
 
 size_t CBOR::Item::size() const
@@ -9,15 +10,35 @@ size_t CBOR::Item::size() const
     {
         case Type::BYTES:
         {
-            return _item->members.value.blob.size();
+            return isSunk() ? (size_t)_item->members.value.sunk.length : _item->members.value.blob.size();
         }
         case Type::STRING:
         {
-            return _item->members.value.text.size();
+            return isSunk() ? (size_t)_item->members.value.sunk.length : _item->members.value.text.size();
         }
         case Type::ARRAY:
         case Type::MAP:
         {
+            if (isLazy())
+            {
+                // the header of the encoding tells the size without decoding the children, unless the
+                // container is of indefinite length and its children have to be counted
+                Reader reader(_item->members.value.encoding);
+                const auto count = reader.enterContainer().second;
+                if (count != INDEFINITE_LENGTH)
+                {
+                    return (size_t)count;
+                }
+
+                size_t size = 0;
+                while (reader.readBreak() != Error::OK && reader.skip() == Error::OK)
+                {
+                    size++;
+                }
+
+                return type() == Type::MAP ? size / 2 : size;
+            }
+
             size_t size = 0;
             for (auto child = _item->members.children.first; child != nullptr; child = child->sibling)
             {
@@ -35,6 +56,16 @@ size_t CBOR::Item::size() const
     return 0;
 }
 
+CBOR::Item CBOR::Item::begin()
+{
+    if (isLazy() && (_model == nullptr || _model->materialize(_item) != Error::OK) && isLazy())
+    {
+        return Item(nullptr, _model);
+    }
+
+    return Item(_item->members.children.first, _model);
+}
+
 CBOR::Item CBOR::Item::operator[](uint32_t index)
 {
     const auto type = Item::type();
@@ -64,6 +95,12 @@ CBOR::Item CBOR::Item::addChild(Type type, std::optional<ValueBuilder> value)
         return Item(nullptr, _model);
     }
 
+    // the new child is appended to the decoded children
+    if (isLazy() && (_model->materialize(_item) != Error::OK) && isLazy())
+    {
+        return Item(nullptr, _model);
+    }
+
     auto* child = _model->itemAllocator().allocate();
     if (child == nullptr)
     {
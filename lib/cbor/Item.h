@@ -4,6 +4,7 @@
 #include <cstdint>
 
 #include <string>
+#include <optional>
 
 #include "Types.h"
 #include "ValueBuilder.h"
@@ -15,12 +16,14 @@ namespace CBOR
 {
 class Decoder;
 class DataModelBase;
+class Encoder;
 
 class Item
 {
 public:
     friend Decoder;
     friend DataModelBase;
+    friend Encoder;
 
     constexpr Item() = default;
 
@@ -93,22 +96,65 @@ public:
 
     constexpr std::span<const uint8_t> toByteString() const
     {
-        return IF_VALID(_item->members.value.blob, std::span<uint8_t>());
+        return IF_VALID(isSunk() ? std::span<const uint8_t>() : _item->members.value.blob, std::span<const uint8_t>());
     }
 
     constexpr std::span<const char> toTextString() const
     {
-        return _item->members.value.text;
+        return isSunk() ? std::span<const char>() : _item->members.value.text;
     }
 
-    constexpr Item getTaggedItem()
+    Item getTaggedItem()
     {
         return begin();
     }
 
-    constexpr Item begin()
+    /***
+     * Get the first child of an array or map. The children of a lazy container are decoded now.
+     * 
+     * @return The first child.
+     */
+    Item begin();
+
+    /***
+     * Check if the children of the array or map are not decoded yet (see DecodeOptions::lazy).
+     * 
+     * @return True if the item is lazy, false otherwise.
+     */
+    constexpr bool isLazy() const
+    {
+        return IF_VALID((_item->flags & item_t::LAZY) != 0, false);
+    }
+
+    /***
+     * Check if the string refers to the input of the decoder (see DecodeOptions::borrow).
+     * 
+     * @return True if the string is borrowed, false otherwise.
+     */
+    constexpr bool isBorrowed() const
+    {
+        return IF_VALID((_item->flags & item_t::BORROWED) != 0, false);
+    }
+
+    /***
+     * Check if the string was written to the sink of the decoder (see DecodeOptions::sink). The model only
+     * holds a placeholder, toByteString() and toTextString() are empty and size() is the length of the string.
+     * 
+     * @return True if the string is sunk, false otherwise.
+     */
+    constexpr bool isSunk() const
+    {
+        return IF_VALID((_item->flags & item_t::SUNK) != 0, false);
+    }
+
+    /***
+     * Get the position of a sunk string in the sink, i.e. the size of the sink before the string was written.
+     * 
+     * @return The offset, 0 if the string is not sunk.
+     */
+    constexpr uint64_t sinkOffset() const
     {
-        return Item(_item->members.children.first, _model);
+        return isSunk() ? _item->members.value.sunk.offset : 0;
     }
 
     constexpr Item end()
@@ -0,0 +1,106 @@
+#ifndef BORON_CBOR_LEVELS_H_
+#define BORON_CBOR_LEVELS_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <vector>
+
+namespace CBOR::Detail
+{
+/***
+ * An open array or map of a message that is scanned without being decoded.
+ */
+struct Level
+{
+    // number of items still expected (keys and values for maps), the number of items so far
+    // if the container is of indefinite length
+    uint64_t remaining;
+
+    bool map;
+
+    bool indefinite;
+};
+
+/***
+ * Stack of the open containers, kept inline up to @p N levels and on the heap beyond. The inline levels
+ * are left uninitialized, a large @p N costs nothing until it is used. Scans that track other state per
+ * container use their own level type @p T.
+ */
+template <size_t N, typename T = Level>
+class LevelStack
+{
+public:
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    T& back()
+    {
+        return _size <= _inline.size() ? _inline[_size - 1] : _spilled.back();
+    }
+
+    void push(const T& level)
+    {
+        if (_size < _inline.size())
+        {
+            _inline[_size] = level;
+        }
+        else
+        {
+            _spilled.push_back(level);
+        }
+
+        _size++;
+    }
+
+    void pop()
+    {
+        if (_size > _inline.size())
+        {
+            _spilled.pop_back();
+        }
+
+        _size--;
+    }
+
+private:
+    std::array<T, N> _inline;
+
+    std::vector<T> _spilled;
+
+    size_t _size = 0;
+};
+
+/***
+ * Complete an item and close all containers of definite length completed by it.
+ */
+template <size_t N>
+inline void complete(LevelStack<N>& levels)
+{
+    while (levels.empty() == false)
+    {
+        auto& level = levels.back();
+        if (level.indefinite)
+        {
+            level.remaining++;
+            return;
+        }
+        else if (--level.remaining > 0)
+        {
+            return;
+        }
+
+        levels.pop();
+    }
+}
+} // namespace CBOR::Detail
+
+#endif // BORON_CBOR_LEVELS_H_
\ No newline at end of file
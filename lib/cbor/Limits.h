@@ -0,0 +1,51 @@
+#ifndef BORON_CBOR_LIMITS_H_
+#define BORON_CBOR_LIMITS_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <chrono>
+
+namespace CBOR
+{
+/***
+ * Default limit for the nesting of arrays and maps.
+ */
+constexpr size_t DEFAULT_MAX_DEPTH = 1024;
+
+/***
+ * Budgets of a single message, so that hostile input cannot make the Decoder allocate without bound. Every
+ * budget is checked before anything is allocated, declared lengths are charged up front: an array that
+ * claims 2^32 children fails at its header. The nesting is limited by DecodeOptions::maxDepth.
+ */
+struct DecodeLimits
+{
+    static constexpr uint64_t UNLIMITED = UINT64_MAX;
+
+    /***
+     * The maximum number of items (keys of maps are items, tags are not), more fail with
+     * Error::ITEM_LIMIT_EXCEEDED. The children of a lazy container are counted when it is decoded, against
+     * budgets of their own.
+     */
+    uint64_t maxItems = UNLIMITED;
+
+    /***
+     * The maximum number of bytes copied to the blob allocator, more fail with Error::BLOB_LIMIT_EXCEEDED.
+     * Borrowed strings are not counted.
+     */
+    uint64_t maxBlobBytes = UNLIMITED;
+
+    /***
+     * The maximum length of a byte or text string, longer ones fail with Error::STRING_TOO_LONG.
+     */
+    uint64_t maxStringLength = UNLIMITED;
+
+    /***
+     * The time by which decoding must be done, later it fails with Error::DEADLINE_EXCEEDED. The clock is
+     * only read every few hundred items.
+     */
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+} // namespace CBOR
+
+#endif // BORON_CBOR_LIMITS_H_
\ No newline at end of file
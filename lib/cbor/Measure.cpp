@@ -0,0 +1,121 @@
+#include "Measure.h"
+
+#include <algorithm>
+
+#include "Decoding.h"
+#include "Levels.h"
+#include "../Buffers.h"
+
+using CBOR::Detail::Level;
+
+std::pair<CBOR::Error, CBOR::Measurement> CBOR::measure(std::span<const uint8_t> data)
+{
+    SpanInputBuffer input(data);
+
+    Measurement measurement;
+    Detail::LevelStack<64> levels;
+    bool tagged = false;
+
+    do
+    {
+        const auto [error, header] = Decoding::decode(input);
+        if (error != Error::OK)
+        {
+            return std::make_pair(error, measurement);
+        }
+
+        if (header.isBreak())
+        {
+            if (tagged || levels.empty() || levels.back().indefinite == false || (levels.back().map && (levels.back().remaining % 2) != 0))
+            {
+                return std::make_pair(Error::MALFORMED_MESSAGE, measurement);
+            }
+
+            levels.pop();
+            Detail::complete(levels);
+            continue;
+        }
+
+        if (header.majorType() == MajorType::TAGGED)
+        {
+            if (tagged)
+            {
+                return std::make_pair(Error::DOUBLE_TAGGED, measurement);
+            }
+
+            // the tag is stored with the item following it
+            tagged = true;
+            continue;
+        }
+
+        tagged = false;
+
+        switch (header.majorType())
+        {
+            case MajorType::BYTE_STRING:
+            case MajorType::TEXT_STRING:
+            {
+                measurement.items++;
+
+                if (header.indefinite())
+                {
+                    const auto [chunksError, chunks] = Decoding::scanChunks(input.unread(), header.majorType());
+                    if (chunksError != Error::OK)
+                    {
+                        return std::make_pair(chunksError, measurement);
+                    }
+
+                    input.readSpan(chunks.size);
+                    measurement.blobBytes += (size_t)chunks.length;
+                }
+                else
+                {
+                    measurement.blobBytes += header.payload().size();
+                }
+
+                Detail::complete(levels);
+                break;
+            }
+            case MajorType::ARRAY:
+            case MajorType::MAP:
+            {
+                measurement.items++;
+                measurement.maxDepth = std::max(measurement.maxDepth, levels.size() + 1);
+
+                const auto isMap = header.majorType() == MajorType::MAP;
+                if (header.indefinite())
+                {
+                    levels.push(Level{ 0, isMap, true });
+                    break;
+                }
+
+                // every item takes at least one byte, hostile counts fail without being counted down
+                if (header.argument() > input.remaining() || (isMap && header.argument() * 2 > input.remaining()))
+                {
+                    return std::make_pair(Error::UNEXPECTED_EOF, measurement);
+                }
+
+                if (header.argument() > 0)
+                {
+                    levels.push(Level{ isMap ? header.argument() * 2 : header.argument(), isMap, false });
+                }
+                else
+                {
+                    Detail::complete(levels);
+                }
+
+                break;
+            }
+            default:
+            {
+                measurement.items++;
+                Detail::complete(levels);
+                break;
+            }
+        }
+    } while (levels.empty() == false || tagged);
+
+    measurement.size = input.size();
+
+    return std::make_pair(Error::OK, measurement);
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef BORON_CBOR_MEASURE_H_
+#define BORON_CBOR_MEASURE_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+#include <utility>
+
+#include "Types.h"
+
+namespace CBOR
+{
+/***
+ * What decoding a message takes, as determined by measure().
+ */
+struct Measurement
+{
+    // number of items the Decoder allocates (keys of maps are items, tags are not)
+    size_t items = 0;
+
+    // number of bytes of byte and text strings the Decoder copies to the blob allocator
+    size_t blobBytes = 0;
+
+    // deepest nesting of arrays and maps, the root container is at depth 1
+    size_t maxDepth = 0;
+
+    // number of bytes of the message
+    size_t size = 0;
+};
+
+/***
+ * Determine the number of items, the number of string bytes and the nesting of a message without
+ * decoding it, so that a model can be sized up front (see DataModelBase::reserve()). Only the headers are
+ * read, strings are skipped and nothing is allocated unless arrays and maps are nested deeper than 64 levels.
+ * 
+ * The numbers are those of an eager decode that copies strings, a message that measures without error
+ * may still fail to decode (e.g. because of an unsupported key type).
+ * 
+ * @param data The message.
+ * 
+ * @return A pair with the error and the measurement.
+ */
+std::pair<Error, Measurement> measure(std::span<const uint8_t> data);
+} // namespace CBOR
+
+#endif // BORON_CBOR_MEASURE_H_
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "Path.h"
+
+#include <algorithm>
+#include <charconv>
+
+#include "Reader.h"
+
+namespace
+{
+using Step = CBOR::Path::Step;
+
+/***
+ * Walks the message with a Reader, one level of the message per step of the path.
+ */
+class Selector
+{
+public:
+    Selector(std::span<const uint8_t> data, const CBOR::Path& path, std::vector<std::span<const uint8_t>>& matches) :
+        _data(data), _reader(data), _steps(path.steps()), _single(path.single()), _matches(matches) {}
+
+    /***
+     * Match the next item against the steps from @p step on.
+     */
+    CBOR::Error select(size_t step)
+    {
+        if (step == _steps.size())
+        {
+            const auto start = _reader.position();
+            if (const auto error = _reader.skip(); error != CBOR::Error::OK)
+            {
+                return error;
+            }
+
+            _matches.push_back(_data.subspan(start, _reader.position() - start));
+            return CBOR::Error::OK;
+        }
+
+        const auto [typeError, type] = _reader.peekType();
+        if (typeError != CBOR::Error::OK)
+        {
+            return typeError;
+        }
+        else if (type != CBOR::Type::ARRAY && type != CBOR::Type::MAP)
+        {
+            // nothing below a scalar matches
+            return _reader.skip();
+        }
+
+        const auto [error, count] = _reader.enterContainer();
+        if (error != CBOR::Error::OK)
+        {
+            return error;
+        }
+
+        const auto& current = _steps[step];
+        for (uint64_t i = 0; ; ++i)
+        {
+            if (count == CBOR::INDEFINITE_LENGTH)
+            {
+                if (const auto breakError = _reader.readBreak(); breakError == CBOR::Error::OK)
+                {
+                    break;
+                }
+                else if (breakError != CBOR::Error::UNEXPECTED_TYPE)
+                {
+                    return breakError;
+                }
+            }
+            else if (i == count)
+            {
+                break;
+            }
+
+            auto selected = current.kind == Step::Kind::WILDCARD;
+            if (type == CBOR::Type::MAP)
+            {
+                const auto [keyError, matching] = matchKey(current);
+                if (keyError != CBOR::Error::OK)
+                {
+                    return keyError;
+                }
+
+                selected = selected || matching;
+            }
+            else
+            {
+                selected = selected || (current.kind == Step::Kind::INDEX && current.index >= 0 && (uint64_t)current.index == i);
+            }
+
+            if (const auto childError = selected ? select(step + 1) : _reader.skip(); childError != CBOR::Error::OK)
+            {
+                return childError;
+            }
+
+            // the rest of the message is not needed once the only possible match is found
+            if (done())
+            {
+                return CBOR::Error::OK;
+            }
+        }
+
+        return CBOR::Error::OK;
+    }
+
+    bool done() const
+    {
+        return _single && _matches.empty() == false;
+    }
+
+private:
+    /***
+     * Read the next key of a map and check if it matches @p step.
+     */
+    std::pair<CBOR::Error, bool> matchKey(const Step& step)
+    {
+        const auto [error, type] = _reader.peekType();
+        if (error != CBOR::Error::OK)
+        {
+            return std::make_pair(error, false);
+        }
+
+        if (step.kind == Step::Kind::KEY && type == CBOR::Type::STRING)
+        {
+            const auto [textError, text] = _reader.readText();
+            if (textError == CBOR::Error::OK)
+            {
+                return std::make_pair(CBOR::Error::OK, text == step.key);
+            }
+        }
+        else if (step.kind == Step::Kind::INDEX && type == CBOR::Type::INTEGER)
+        {
+            const auto [intError, value] = _reader.readInt();
+            if (intError == CBOR::Error::OK)
+            {
+                return std::make_pair(CBOR::Error::OK, value == step.index);
+            }
+        }
+
+        return std::make_pair(_reader.skip(), false);
+    }
+
+    std::span<const uint8_t> _data;
+
+    CBOR::Reader _reader;
+
+    const std::vector<Step>& _steps;
+
+    bool _single = false;
+
+    std::vector<std::span<const uint8_t>>& _matches;
+};
+
+/***
+ * Parse the part of a bracketed step between the brackets.
+ */
+std::pair<CBOR::Error, Step> parseBracket(std::string_view text)
+{
+    Step step;
+    if (text == "*")
+    {
+        step.kind = Step::Kind::WILDCARD;
+        return std::make_pair(CBOR::Error::OK, step);
+    }
+
+    if (text.size() >= 2 && (text.front() == '"' || text.front() == '\'') && text.back() == text.front())
+    {
+        step.kind = Step::Kind::KEY;
+        step.key = text.substr(1, text.size() - 2);
+        const auto valid = step.key.find(text.front()) == std::string::npos;
+        return std::make_pair(valid ? CBOR::Error::OK : CBOR::Error::MALFORMED_PATH, step);
+    }
+
+    step.kind = Step::Kind::INDEX;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), step.index);
+    const auto valid = text.empty() == false && error == std::errc() && end == text.data() + text.size();
+    return std::make_pair(valid ? CBOR::Error::OK : CBOR::Error::MALFORMED_PATH, step);
+}
+} // namespace
+
+std::pair<CBOR::Error, CBOR::Path> CBOR::Path::compile(std::string_view expression)
+{
+    Path path;
+    if (expression.empty() || expression.front() != '$')
+    {
+        return std::make_pair(Error::MALFORMED_PATH, path);
+    }
+
+    size_t i = 1;
+    while (i < expression.size())
+    {
+        if (expression[i] == '.')
+        {
+            const auto end = std::min(expression.find_first_of(".[", i + 1), expression.size());
+            const auto name = expression.substr(i + 1, end - i - 1);
+            if (name.empty())
+            {
+                return std::make_pair(Error::MALFORMED_PATH, Path());
+            }
+
+            Step step;
+            step.kind = name == "*" ? Step::Kind::WILDCARD : Step::Kind::KEY;
+            step.key = step.kind == Step::Kind::KEY ? name : std::string_view();
+            path._steps.push_back(std::move(step));
+            i = end;
+        }
+        else if (expression[i] == '[')
+        {
+            // a quoted key may contain brackets
+            auto close = expression.find(']', i + 1);
+            if (i + 1 < expression.size() && (expression[i + 1] == '"' || expression[i + 1] == '\''))
+            {
+                const auto quote = expression.find(expression[i + 1], i + 2);
+                close = quote == std::string_view::npos ? quote : expression.find(']', quote + 1);
+            }
+
+            if (close == std::string_view::npos)
+            {
+                return std::make_pair(Error::MALFORMED_PATH, Path());
+            }
+
+            auto [error, step] = parseBracket(expression.substr(i + 1, close - i - 1));
+            if (error != Error::OK)
+            {
+                return std::make_pair(error, Path());
+            }
+
+            path._steps.push_back(std::move(step));
+            i = close + 1;
+        }
+        else
+        {
+            return std::make_pair(Error::MALFORMED_PATH, Path());
+        }
+    }
+
+    return std::make_pair(Error::OK, std::move(path));
+}
+
+bool CBOR::Path::single() const
+{
+    return std::none_of(_steps.begin(), _steps.end(), [](const Step& step) { return step.kind == Step::Kind::WILDCARD; });
+}
+
+CBOR::Error CBOR::select(std::span<const uint8_t> data, const Path& path, std::vector<std::span<const uint8_t>>& matches)
+{
+    matches.clear();
+
+    Selector selector(data, path, matches);
+    return selector.select(0);
+}
+
+CBOR::Error CBOR::select(std::span<const uint8_t> data, const Path& path, DataModelBase& model, const DecodeOptions& options)
+{
+    std::vector<std::span<const uint8_t>> matches;
+    if (const auto error = select(data, path, matches); error != Error::OK)
+    {
+        return error;
+    }
+
+    Decoder decoder(model, options);
+    return decoder.decodeSelection(data, matches).first;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef BORON_CBOR_PATH_H_
+#define BORON_CBOR_PATH_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Types.h"
+#include "DataModelBase.h"
+#include "Decoder.h"
+
+namespace CBOR
+{
+/***
+ * A compiled path expression selecting items of a message, e.g. "$.meta.id" or "$.samples[*].value".
+ * 
+ * The expression starts with "$" for the root, followed by steps into arrays and maps:
+ *  - ".name" or ["name"] selects the value of a map for a text key,
+ *  - [n] selects the element n of an array or the value of a map for the integer key n,
+ *  - .* or [*] selects all elements of an array or all values of a map.
+ */
+class Path
+{
+public:
+    struct Step
+    {
+        enum class Kind : uint8_t
+        {
+            KEY,
+            INDEX,
+            WILDCARD
+        };
+
+        Kind kind = Kind::WILDCARD;
+
+        std::string key;
+
+        int64_t index = 0;
+    };
+
+    Path() = default;
+
+    /***
+     * Compile a path expression.
+     * 
+     * @param expression The expression.
+     * 
+     * @return A pair with the error (Error::MALFORMED_PATH if the expression is invalid) and the path.
+     */
+    static std::pair<Error, Path> compile(std::string_view expression);
+
+    constexpr const std::vector<Step>& steps() const
+    {
+        return _steps;
+    }
+
+    /***
+     * Check if the path selects at most one item, i.e. it has no wildcards.
+     * 
+     * @return True if the path selects at most one item, false otherwise.
+     */
+    bool single() const;
+
+private:
+    std::vector<Step> _steps;
+};
+
+/***
+ * Select the items matching a path without decoding the message. Subtrees that cannot match are skipped
+ * by their lengths (see Reader::skip()), a path without wildcards stops at its first match. Keys that are
+ * text strings of indefinite length never match.
+ * 
+ * @param data The message.
+ * @param path The path.
+ * @param matches The encodings of the matching items (including their tags) in the order of the message,
+ *                views into @p data.
+ * 
+ * @return Error
+ */
+Error select(std::span<const uint8_t> data, const Path& path, std::vector<std::span<const uint8_t>>& matches);
+
+/***
+ * Select the items matching a path and decode only them (see Decoder::decodeSelection()). The root of
+ * @p model is an array whose children are the matches.
+ * 
+ * @param data The message.
+ * @param path The path.
+ * @param model The model of the matches.
+ * @param options The options of the decoder, lazy and borrowed items refer to @p data.
+ * 
+ * @return Error
+ */
+Error select(std::span<const uint8_t> data, const Path& path, DataModelBase& model, const DecodeOptions& options = {});
+} // namespace CBOR
+
+#endif // BORON_CBOR_PATH_H_
\ No newline at end of file
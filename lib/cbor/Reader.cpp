@@ -0,0 +1,389 @@
+#include "Reader.h"
+
+#include <tuple>
+
+#include "Decoding.h"
+#include "Levels.h"
+#include "../Bytes.h"
+#include "../Float16.h"
+
+namespace
+{
+// containers of indefinite length skipped without allocating, deeper nesting spills to the heap
+constexpr size_t INLINE_SKIP_LEVELS = 64;
+
+/***
+ * An open array or map of indefinite length, the items of the levels around it wait until its break.
+ */
+struct SkipLevel
+{
+    uint64_t pending;
+
+    // number of children so far, a map must not end after a key
+    uint64_t children;
+
+    bool map;
+};
+
+std::pair<CBOR::Error, CBOR::Type> typeOf(const CBOR::Header& header)
+{
+    using namespace CBOR;
+
+    switch (header.majorType())
+    {
+        case MajorType::UNSIGNED_INT:
+        case MajorType::SIGNED_INT:
+        {
+            return std::make_pair(Error::OK, Type::INTEGER);
+        }
+        case MajorType::BYTE_STRING:
+        {
+            return std::make_pair(Error::OK, Type::BYTES);
+        }
+        case MajorType::TEXT_STRING:
+        {
+            return std::make_pair(Error::OK, Type::STRING);
+        }
+        case MajorType::ARRAY:
+        {
+            return std::make_pair(Error::OK, Type::ARRAY);
+        }
+        case MajorType::MAP:
+        {
+            return std::make_pair(Error::OK, Type::MAP);
+        }
+        case MajorType::FLOAT_OR_SIMPLE:
+        {
+            switch ((FloatOrSimpleArgumentType)header.argument())
+            {
+                case FloatOrSimpleArgumentType::FALSE:
+                case FloatOrSimpleArgumentType::TRUE:
+                {
+                    return std::make_pair(Error::OK, Type::BOOL);
+                }
+                case FloatOrSimpleArgumentType::NULLVAL:
+                {
+                    return std::make_pair(Error::OK, Type::NULLVAL);
+                }
+                case FloatOrSimpleArgumentType::UNDEFINED:
+                {
+                    return std::make_pair(Error::OK, Type::UNDEFINED);
+                }
+                case FloatOrSimpleArgumentType::FLOAT16:
+                case FloatOrSimpleArgumentType::FLOAT32:
+                case FloatOrSimpleArgumentType::FLOAT64:
+                {
+                    return std::make_pair(Error::OK, Type::FLOAT);
+                }
+                case FloatOrSimpleArgumentType::BREAK:
+                {
+                    return std::make_pair(Error::MALFORMED_MESSAGE, Type::UNDEFINED);
+                }
+                default:
+                {
+                    return std::make_pair(Error::UNSUPPORTED_SIMPLE, Type::UNDEFINED);
+                }
+            }
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    return std::make_pair(Error::MALFORMED_MESSAGE, Type::UNDEFINED);
+}
+} // namespace
+
+std::pair<CBOR::Error, CBOR::Type> CBOR::Reader::peekType()
+{
+    const auto mark = _input.mark();
+
+    auto [error, header] = Decoding::decode(_input);
+    if (error == Error::OK && header.majorType() == MajorType::TAGGED)
+    {
+        std::tie(error, header) = Decoding::decode(_input);
+    }
+
+    _input.rewind(mark);
+
+    if (error != Error::OK)
+    {
+        return std::make_pair(error, Type::UNDEFINED);
+    }
+
+    return typeOf(header);
+}
+
+std::pair<CBOR::Error, CBOR::Header> CBOR::Reader::next()
+{
+    const auto mark = _input.mark();
+
+    const auto result = Decoding::decode(_input);
+    if (result.first != Error::OK)
+    {
+        _input.rewind(mark);
+    }
+
+    return result;
+}
+
+std::pair<CBOR::Error, uint64_t> CBOR::Reader::enterContainer()
+{
+    const auto mark = _input.mark();
+
+    auto [error, header] = readItem(Type::ARRAY);
+    if (error == Error::UNEXPECTED_TYPE)
+    {
+        std::tie(error, header) = readItem(Type::MAP);
+    }
+
+    if (error != Error::OK)
+    {
+        return std::make_pair(error, 0);
+    }
+
+    if (header.indefinite())
+    {
+        return std::make_pair(Error::OK, INDEFINITE_LENGTH);
+    }
+
+    // every item takes at least one byte, larger counts can be rejected without looking at the children
+    const auto items = header.majorType() == MajorType::MAP ? header.argument() * 2 : header.argument();
+    if (header.argument() > _input.remaining() || items > _input.remaining())
+    {
+        _input.rewind(mark);
+        return std::make_pair(Error::UNEXPECTED_EOF, 0);
+    }
+
+    return std::make_pair(Error::OK, header.argument());
+}
+
+CBOR::Error CBOR::Reader::readBreak()
+{
+    const auto mark = _input.mark();
+
+    const auto [error, header] = Decoding::decode(_input);
+    if (error != Error::OK || header.isBreak() == false)
+    {
+        _input.rewind(mark);
+        return error != Error::OK ? error : Error::UNEXPECTED_TYPE;
+    }
+
+    return Error::OK;
+}
+
+CBOR::Error CBOR::Reader::skip()
+{
+    const auto mark = _input.mark();
+
+    CBOR::Detail::LevelStack<INLINE_SKIP_LEVELS, SkipLevel> open;
+
+    // number of items still to be skipped (in the innermost container of indefinite length, if any),
+    // bounded by the remaining bytes
+    uint64_t pending = 1;
+    while (pending > 0 || open.empty() == false)
+    {
+        const auto [error, header] = Decoding::decode(_input);
+        if (error != Error::OK)
+        {
+            _input.rewind(mark);
+            return error;
+        }
+
+        if (header.isBreak())
+        {
+            if (pending > 0 || open.empty() || (open.back().map && (open.back().children % 2) != 0))
+            {
+                _input.rewind(mark);
+                return Error::MALFORMED_MESSAGE;
+            }
+
+            pending = open.back().pending;
+            open.pop();
+            continue;
+        }
+
+        if (pending > 0)
+        {
+            pending--;
+        }
+        else
+        {
+            // a direct child of a container of indefinite length
+            open.back().children++;
+        }
+
+        uint64_t children = 0;
+        switch (header.majorType())
+        {
+            case MajorType::BYTE_STRING:
+            case MajorType::TEXT_STRING:
+            {
+                if (header.indefinite())
+                {
+                    const auto [chunksError, chunks] = Decoding::scanChunks(_input.unread(), header.majorType());
+                    if (chunksError != Error::OK)
+                    {
+                        _input.rewind(mark);
+                        return chunksError;
+                    }
+
+                    _input.readSpan(chunks.size);
+                }
+
+                break;
+            }
+            case MajorType::ARRAY:
+            case MajorType::MAP:
+            {
+                if (header.indefinite())
+                {
+                    open.push(SkipLevel{ pending, 0, header.majorType() == MajorType::MAP });
+                    pending = 0;
+                }
+                else if (header.majorType() == MajorType::MAP)
+                {
+                    // guard the multiplication, too many pairs fail below anyway
+                    children = header.argument() > _input.remaining() ? UINT64_MAX : header.argument() * 2;
+                }
+                else
+                {
+                    children = header.argument();
+                }
+
+                break;
+            }
+            case MajorType::TAGGED:
+            {
+                children = 1;
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+
+        // every item takes at least one byte, hostile lengths fail without being counted down
+        if (children > _input.remaining() - std::min(pending, _input.remaining()))
+        {
+            _input.rewind(mark);
+            return Error::UNEXPECTED_EOF;
+        }
+
+        pending += children;
+    }
+
+    return Error::OK;
+}
+
+std::pair<CBOR::Error, int64_t> CBOR::Reader::readInt()
+{
+    const auto [error, header] = readItem(Type::INTEGER);
+    if (error != Error::OK)
+    {
+        return std::make_pair(error, 0);
+    }
+
+    if (header.majorType() == MajorType::SIGNED_INT)
+    {
+        return std::make_pair(Error::OK, INT64_C(-1) - (int64_t)header.argument());
+    }
+
+    return std::make_pair(Error::OK, (int64_t)header.argument());
+}
+
+std::pair<CBOR::Error, CBOR::Float> CBOR::Reader::readFloat()
+{
+    const auto mark = _input.mark();
+
+    const auto [error, header] = readItem(Type::FLOAT);
+    if (error != Error::OK)
+    {
+        return std::make_pair(error, 0.0);
+    }
+
+    switch ((FloatOrSimpleArgumentType)header.argument())
+    {
+        case FloatOrSimpleArgumentType::FLOAT16:
+        {
+            return std::make_pair(Error::OK, (Float)Float16::toFloat(Bytes::load<uint16_t>(header.payload().data(), Bytes::Endianess::NETWORK)));
+        }
+        case FloatOrSimpleArgumentType::FLOAT32:
+        {
+            return std::make_pair(Error::OK, (Float)Bytes::load<float>(header.payload().data(), Bytes::Endianess::NETWORK));
+        }
+        case FloatOrSimpleArgumentType::FLOAT64:
+        {
+            return std::make_pair(Error::OK, Bytes::load<double>(header.payload().data(), Bytes::Endianess::NETWORK));
+        }
+        default:
+        {
+            _input.rewind(mark);
+            return std::make_pair(Error::UNSUPPORTED_DATATYPE, 0.0);
+        }
+    }
+}
+
+std::pair<CBOR::Error, CBOR::Boolean> CBOR::Reader::readBool()
+{
+    const auto [error, header] = readItem(Type::BOOL);
+    return std::make_pair(error, error == Error::OK && header.argument() == (uint64_t)FloatOrSimpleArgumentType::TRUE);
+}
+
+CBOR::Error CBOR::Reader::readNull()
+{
+    return readItem(Type::NULLVAL).first;
+}
+
+std::pair<CBOR::Error, std::span<const uint8_t>> CBOR::Reader::readBytes()
+{
+    const auto [error, header] = readItem(Type::BYTES);
+    return std::make_pair(error, header.payload());
+}
+
+std::pair<CBOR::Error, std::string_view> CBOR::Reader::readText()
+{
+    const auto [error, header] = readItem(Type::STRING);
+    return std::make_pair(error, std::string_view((const char*)header.payload().data(), header.payload().size()));
+}
+
+std::pair<CBOR::Error, CBOR::Header> CBOR::Reader::readItem(Type expected)
+{
+    const auto mark = _input.mark();
+
+    auto tag = Tag::INVALID;
+    auto [error, header] = Decoding::decode(_input);
+    if (error == Error::OK && header.majorType() == MajorType::TAGGED)
+    {
+        tag = (Tag)header.argument();
+        std::tie(error, header) = Decoding::decode(_input);
+    }
+
+    if (error == Error::OK && header.majorType() == MajorType::TAGGED)
+    {
+        error = Error::DOUBLE_TAGGED;
+    }
+    else if (error == Error::OK && header.indefinite() && (header.majorType() == MajorType::BYTE_STRING || header.majorType() == MajorType::TEXT_STRING))
+    {
+        // the chunks are not contiguous, they cannot be returned as a view
+        error = Error::UNSUPPORTED_DATATYPE;
+    }
+
+    if (error == Error::OK)
+    {
+        const auto [typeError, type] = typeOf(header);
+        error = typeError != Error::OK ? typeError : (type != expected ? Error::UNEXPECTED_TYPE : Error::OK);
+    }
+
+    if (error != Error::OK)
+    {
+        _input.rewind(mark);
+        return std::make_pair(error, Header());
+    }
+
+    _tag = tag;
+
+    return std::make_pair(Error::OK, header);
+}
\ No newline at end of file
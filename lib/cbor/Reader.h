@@ -0,0 +1,130 @@
+#ifndef BORON_CBOR_READER_H_
+#define BORON_CBOR_READER_H_
+
+#include <cstdint>
+
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "Types.h"
+#include "Header.h"
+#include "../Buffers.h"
+
+namespace CBOR
+{
+/***
+ * Pull-style cursor over an encoded message. Items are read one at a time in the order of the encoding,
+ * arrays and maps are entered with enterContainer() and whole items of any size are passed over with skip().
+ * Nothing is allocated (but for skipping more than 64 nested containers of indefinite length) and strings
+ * are returned as views into the message.
+ * 
+ * A failed typed read leaves the cursor in front of the item, so that it can be read as another type.
+ */
+class Reader
+{
+public:
+    constexpr Reader(std::span<const uint8_t> data) :
+        _input(data) {}
+
+    /***
+     * Get the type of the next item (after its tag, if any) without consuming it.
+     * 
+     * @return A pair with the error and the type.
+     */
+    std::pair<Error, Type> peekType();
+
+    /***
+     * Decode the next header, a tag is returned as a header of its own. This is the low-level access the
+     * typed getters are built on, the payload of strings and floats is part of the header.
+     * 
+     * @return A pair with the error and the header.
+     */
+    std::pair<Error, Header> next();
+
+    /***
+     * Enter the next item, which must be an array or a map. Its children (keys and values for maps) follow.
+     * The children of a container of indefinite length are followed by a break, see readBreak().
+     * 
+     * @return A pair with the error and the number of items of an array or pairs of a map,
+     *         INDEFINITE_LENGTH for a container of indefinite length.
+     */
+    std::pair<Error, uint64_t> enterContainer();
+
+    /***
+     * Read the break that ends a container of indefinite length.
+     * 
+     * @return Error::OK if the next item is a break, Error::UNEXPECTED_TYPE otherwise.
+     */
+    Error readBreak();
+
+    /***
+     * Skip the next item including all its children. Nested items are only counted, skipping an item
+     * of any size and depth takes constant memory unless it contains arrays or maps of indefinite length,
+     * which take one counter per open container. The counters of up to 64 nested ones are kept on the
+     * stack, only deeper nesting allocates.
+     * 
+     * @return Error
+     */
+    Error skip();
+
+    std::pair<Error, int64_t> readInt();
+
+    std::pair<Error, Float> readFloat();
+
+    std::pair<Error, Boolean> readBool();
+
+    Error readNull();
+
+    /***
+     * Read a byte string. Strings of indefinite length are not contiguous in the message, they fail with
+     * Error::UNSUPPORTED_DATATYPE and have to be decoded with next().
+     */
+    std::pair<Error, std::span<const uint8_t>> readBytes();
+
+    std::pair<Error, std::string_view> readText();
+
+    /***
+     * Get the tag of the item read last by a typed getter or enterContainer().
+     * 
+     * @return The tag, Tag::INVALID if the item was not tagged.
+     */
+    constexpr Tag tag() const
+    {
+        return _tag;
+    }
+
+    /***
+     * Get the number of bytes consumed.
+     * 
+     * @return The position in the message.
+     */
+    constexpr size_t position() const
+    {
+        return _input.size();
+    }
+
+    constexpr size_t remaining() const
+    {
+        return _input.remaining();
+    }
+
+    constexpr bool atEnd() const
+    {
+        return _input.remaining() == 0;
+    }
+
+private:
+    /***
+     * Decode the header of the next item (after its tag) and check its type. The cursor is only advanced
+     * if the item has the expected type.
+     */
+    std::pair<Error, Header> readItem(Type expected);
+
+    SpanInputBuffer _input;
+
+    Tag _tag = Tag::INVALID;
+};
+} // namespace CBOR
+
+#endif // BORON_CBOR_READER_H_
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "Sequence.h"
+
+#include "Reader.h"
+#include "Shards.h"
+
+using CBOR::Detail::Shard;
+
+namespace
+{
+/***
+ * Split a sequence into shards of at least @p shardSize bytes (but the last) at the boundaries of its items.
+ */
+std::pair<CBOR::Error, size_t> split(std::span<const uint8_t> data, size_t shardSize, std::vector<Shard>& shards)
+{
+    CBOR::Reader reader(data);
+
+    Shard shard;
+    auto error = CBOR::Error::OK;
+    while (reader.atEnd() == false)
+    {
+        // a failed skip stays in front of the item, the items before it are still decoded
+        error = reader.skip();
+        if (error != CBOR::Error::OK)
+        {
+            break;
+        }
+
+        shard.count++;
+        if (reader.position() - shard.offset >= shardSize)
+        {
+            shard.data = data.subspan(shard.offset, reader.position() - shard.offset);
+            shards.push_back(shard);
+            shard = Shard{ {}, 0, reader.position() };
+        }
+    }
+
+    if (shard.count > 0)
+    {
+        shard.data = data.subspan(shard.offset, reader.position() - shard.offset);
+        shards.push_back(shard);
+    }
+
+    return std::make_pair(error, reader.position());
+}
+} // namespace
+
+std::vector<CBOR::Item> CBOR::Sequence::items() const
+{
+    std::vector<Item> items;
+    items.reserve(_size);
+
+    for (const auto& model : _models)
+    {
+        for (auto item = model->root().begin(); bool(item); item = item.sibling())
+        {
+            items.push_back(item);
+        }
+    }
+
+    return items;
+}
+
+std::pair<CBOR::Error, size_t> CBOR::decodeSequence(std::span<const uint8_t> data, Sequence& sequence, size_t threads, const DecodeOptions& options)
+{
+    sequence.clear();
+
+    // the budgets of items and blob bytes are shared by the whole sequence, it is decoded as a single shard
+    const auto budgeted = options.limits.maxItems != DecodeLimits::UNLIMITED || options.limits.maxBlobBytes != DecodeLimits::UNLIMITED;
+    // and the strings have to reach the sink in order
+    threads = budgeted || options.sink != nullptr ? 1 : Detail::threadCount(threads);
+
+    std::vector<Shard> shards;
+    const auto [scanError, scanned] = split(data, budgeted ? data.size() : Detail::shardSize(data.size(), threads), shards);
+
+    std::vector<std::unique_ptr<DynamicDataModel>> models(shards.size());
+    std::vector<std::pair<Error, size_t>> results(shards.size(), std::make_pair(Error::OK, 0));
+
+    Detail::runShards(shards.size(), threads, [&](size_t i)
+    {
+        models[i] = std::make_unique<DynamicDataModel>();
+
+        Decoder decoder(*models[i], options);
+        results[i] = decoder.decodeSequence(shards[i].data, shards[i].count);
+    });
+
+    // the sequence holds the shards up to the first one that failed
+    for (size_t i = 0; i < shards.size(); ++i)
+    {
+        if (results[i].first != Error::OK)
+        {
+            return std::make_pair(results[i].first, shards[i].offset + results[i].second);
+        }
+
+        sequence._models.push_back(std::move(models[i]));
+        sequence._size += shards[i].count;
+    }
+
+    return std::make_pair(scanError, scanned);
+}
\ No newline at end of file
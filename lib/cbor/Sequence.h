@@ -0,0 +1,95 @@
+#ifndef BORON_CBOR_SEQUENCE_H_
+#define BORON_CBOR_SEQUENCE_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Types.h"
+#include "Item.h"
+#include "DataModel.h"
+#include "Decoder.h"
+
+namespace CBOR
+{
+/***
+ * The items of a decoded RFC 8742 sequence. The sequence is decoded in shards of consecutive items, every
+ * shard is a model of its own whose root array holds the items.
+ */
+class Sequence
+{
+public:
+    Sequence() = default;
+
+    /***
+     * Get the number of items.
+     */
+    constexpr size_t size() const
+    {
+        return _size;
+    }
+
+    constexpr size_t shards() const
+    {
+        return _models.size();
+    }
+
+    /***
+     * Get a shard, its children are the items of the shard in the order of the sequence.
+     * 
+     * @param index The index of the shard.
+     * 
+     * @return The root array of the shard.
+     */
+    Item shard(size_t index) const
+    {
+        return _models[index]->root();
+    }
+
+    /***
+     * Collect the items of all shards in the order of the sequence.
+     * 
+     * @return The items.
+     */
+    std::vector<Item> items() const;
+
+    void clear()
+    {
+        _models.clear();
+        _size = 0;
+    }
+
+private:
+    friend std::pair<Error, size_t> decodeSequence(std::span<const uint8_t>, Sequence&, size_t, const DecodeOptions&);
+
+    std::vector<std::unique_ptr<DynamicDataModel>> _models;
+
+    size_t _size = 0;
+};
+
+/***
+ * Decode an RFC 8742 sequence on multiple threads. The boundaries of the items are determined by a scan of
+ * their headers (see Reader::skip()), the items are split into shards of about the same number of bytes and
+ * the shards are decoded concurrently into models of their own.
+ * 
+ * If an item is malformed or incomplete (e.g. at the end of a file that is still being written), the items
+ * before it are decoded and the error is returned with the number of bytes of those items. Any other error
+ * is returned with the position it occurred at, the sequence then holds the shards before the failed one.
+ * 
+ * @param data The sequence.
+ * @param sequence The decoded items.
+ * @param threads The number of threads, 0 to use one per core.
+ * @param options The options of the decoders, lazy and borrowed items refer to @p data. The budgets of
+ *                items and blob bytes apply to the whole sequence, which is then decoded on a single thread.
+ *                With a sink the shards are decoded one after another.
+ * 
+ * @return A pair with the error and the number of bytes decoded.
+ */
+std::pair<Error, size_t> decodeSequence(std::span<const uint8_t> data, Sequence& sequence, size_t threads = 0, const DecodeOptions& options = {});
+} // namespace CBOR
+
+#endif // BORON_CBOR_SEQUENCE_H_
\ No newline at end of file
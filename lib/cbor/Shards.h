@@ -0,0 +1,83 @@
+#ifndef BORON_CBOR_SHARDS_H_
+#define BORON_CBOR_SHARDS_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <atomic>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace CBOR::Detail
+{
+// more shards than threads even out items that take very different time to decode
+constexpr size_t SHARDS_PER_THREAD = 4;
+
+// smaller shards are not worth a model of their own
+constexpr size_t MIN_SHARD_SIZE = 64 * 1024;
+
+/***
+ * Consecutive items decoded by one thread into a model of their own.
+ */
+struct Shard
+{
+    std::span<const uint8_t> data;
+
+    // number of items in the shard (keys and values for maps)
+    uint64_t count = 0;
+
+    // position of the shard in the input
+    size_t offset = 0;
+};
+
+/***
+ * Get the number of threads to use, one per core if @p threads is 0.
+ */
+inline size_t threadCount(size_t threads)
+{
+    return threads > 0 ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/***
+ * Get the size of the shards for @p bytes of input decoded on @p threads threads.
+ */
+constexpr size_t shardSize(size_t bytes, size_t threads)
+{
+    return std::max(bytes / (threads * SHARDS_PER_THREAD), MIN_SHARD_SIZE);
+}
+
+/***
+ * Call @p work with the index of every shard, on up to @p threads threads including the calling one.
+ * The shards are taken in order.
+ */
+template <typename Work>
+inline void runShards(size_t shards, size_t threads, const Work& work)
+{
+    std::atomic<size_t> next = 0;
+    const auto run = [&]()
+    {
+        for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < shards; i = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            work(i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(std::min(threads, shards));
+    for (size_t i = 1; i < std::min(threads, shards); ++i)
+    {
+        workers.emplace_back(run);
+    }
+
+    run();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+} // namespace CBOR::Detail
+
+#endif // BORON_CBOR_SHARDS_H_
\ No newline at end of file
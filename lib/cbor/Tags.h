@@ -79,10 +79,10 @@ enum class Tag : uint64_t
     TYPED_ARRAY_FLOAT32_BIG = 81, // byte string
     TYPED_ARRAY_FLOAT64_BIG = 82, // byte string
     TYPED_ARRAY_FLOAT128_BIG = 83, // byte string
-    TYPED_ARRAY_FLOAT16_LITTLE = 80, // byte string
-    TYPED_ARRAY_FLOAT32_LITTLE = 81, // byte string
-    TYPED_ARRAY_FLOAT64_LITTLE = 82, // byte string
-    TYPED_ARRAY_FLOAT128_LITTLE = 83, // byte string
+    TYPED_ARRAY_FLOAT16_LITTLE = 84, // byte string
+    TYPED_ARRAY_FLOAT32_LITTLE = 85, // byte string
+    TYPED_ARRAY_FLOAT64_LITTLE = 86, // byte string
+    TYPED_ARRAY_FLOAT128_LITTLE = 87, // byte string
     EMBEDDED_JSON_OBJECT = 262, // text string
     HEXADECIMAL_STRING = 263, // text string
     EXTENDED_TIME = 1001, // map
@@ -126,10 +126,10 @@ public:
         constexpr Value(Boolean b) :
             s(b ? Simple::TRUE : Simple::FALSE) {}
 
-        constexpr Value(std::span<char> text) :
+        constexpr Value(std::span<const char> text) :
             text(text) {}
 
-        constexpr Value(std::span<uint8_t> blob) :
+        constexpr Value(std::span<const uint8_t> blob) :
             blob(blob) {}
 
         constexpr Value(Simple s) :
@@ -143,9 +143,20 @@ public:
 
             Simple s;
 
-            std::span<char> text;
+            std::span<const char> text;
 
-            std::span<uint8_t> blob;
+            std::span<const uint8_t> blob;
+
+            // encoding of a lazy array or map (see LAZY)
+            std::span<const uint8_t> encoding;
+
+            // position of a string in the sink of the decoder and its length (see SUNK)
+            struct
+            {
+                uint64_t offset;
+
+                uint64_t length;
+            } sunk;
         };
     };
 
@@ -172,6 +183,18 @@ public:
         };
     };
 
+    enum Flags : uint8_t
+    {
+        // the children of the array or map are not decoded yet, members.value.encoding refers to its encoding
+        LAZY = 0x01,
+
+        // the string refers to the input of the decoder instead of memory of the blob allocator
+        BORROWED = 0x02,
+
+        // the string was written to the sink of the decoder, members.value.sunk tells where
+        SUNK = 0x04
+    };
+
     constexpr item_t() = default;
 
     constexpr item_t(Type type, item_t* parent, const Members& members) :
@@ -195,6 +218,11 @@ public:
 
     Type type = Type::UNDEFINED;
 
+    uint8_t flags = 0;
+
+    // nesting level of a lazy array or map (see LAZY), the root is at level 1
+    uint32_t depth = 0;
+
     item_t* parent = nullptr;
 
     item_t* key = nullptr;
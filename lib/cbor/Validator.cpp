@@ -0,0 +1,181 @@
+#include "Validator.h"
+
+#include "Decoding.h"
+#include "InitTable.h"
+#include "Levels.h"
+#include "../Utf8.h"
+
+using CBOR::Detail::Level;
+
+std::pair<CBOR::Error, size_t> CBOR::validate(std::span<const uint8_t> data, const ValidateOptions& options)
+{
+    const auto* const begin = data.data();
+    const auto* const end = begin + data.size();
+    const auto* p = begin;
+
+    const auto fail = [&](Error error)
+    {
+        return std::make_pair(error, (size_t)(p - begin));
+    };
+
+    Detail::LevelStack<DEFAULT_MAX_DEPTH> levels;
+    bool tagged = false;
+
+    do
+    {
+        if (p == end)
+        {
+            return fail(Error::UNEXPECTED_EOF);
+        }
+
+        const auto& rule = INIT_TABLE[*p];
+        if (rule.kind == InitKind::MALFORMED)
+        {
+            return fail(Error::MALFORMED_MESSAGE);
+        }
+        else if (rule.kind == InitKind::BREAK)
+        {
+            if (tagged || levels.empty() || levels.back().indefinite == false || (levels.back().map && (levels.back().remaining % 2) != 0))
+            {
+                return fail(Error::MALFORMED_MESSAGE);
+            }
+
+            p++;
+            levels.pop();
+            Detail::complete(levels);
+            continue;
+        }
+
+        const auto indefinite = rule.kind == InitKind::INDEFINITE;
+        const auto kind = indefinite ? INIT_TABLE[(uint8_t)rule.majorType << 5].kind : rule.kind;
+
+        const auto available = (size_t)(end - p) - 1;
+        uint64_t argument = rule.additional;
+        if (rule.argumentLength > 0)
+        {
+            if (available < rule.argumentLength)
+            {
+                return fail(Error::UNEXPECTED_EOF);
+            }
+
+            argument = loadArgument(p + 1, rule.argumentLength, available);
+            if (argument < rule.minimum)
+            {
+                return fail(Error::MALFORMED_ARGUMENT);
+            }
+        }
+
+        if (kind == InitKind::TAGGED)
+        {
+            if (tagged)
+            {
+                return fail(Error::DOUBLE_TAGGED);
+            }
+
+            // the tag applies to the item following it
+            tagged = true;
+            p += 1 + rule.argumentLength;
+            continue;
+        }
+
+        // the keys of maps are integers and text strings
+        const auto isKey = levels.empty() == false && levels.back().map && (levels.back().remaining % 2) == 0;
+        if (isKey && kind != InitKind::UNSIGNED_INT && kind != InitKind::SIGNED_INT && kind != InitKind::TEXT_STRING)
+        {
+            return fail(Error::UNSUPPORTED_KEY_TYPE);
+        }
+
+        const auto* const payload = p + 1 + rule.argumentLength;
+        switch (kind)
+        {
+            case InitKind::BYTE_STRING:
+            case InitKind::TEXT_STRING:
+            {
+                if (indefinite)
+                {
+                    const auto chunksData = std::span<const uint8_t>(payload, end);
+                    const auto [error, chunks] = Decoding::scanChunks(chunksData, rule.majorType);
+                    if (error != Error::OK)
+                    {
+                        return fail(error);
+                    }
+                    else if (options.utf8 && kind == InitKind::TEXT_STRING && Decoding::validateChunks(chunksData) == false)
+                    {
+                        return fail(Error::INVALID_UTF8);
+                    }
+
+                    p = payload + chunks.size;
+                }
+                else
+                {
+                    if ((uint64_t)(end - payload) < argument)
+                    {
+                        return fail(Error::UNEXPECTED_EOF);
+                    }
+                    else if (options.utf8 && kind == InitKind::TEXT_STRING && Utf8::validate(std::span<const uint8_t>(payload, (size_t)argument)) == false)
+                    {
+                        return fail(Error::INVALID_UTF8);
+                    }
+
+                    p = payload + argument;
+                }
+
+                break;
+            }
+            case InitKind::ARRAY:
+            case InitKind::MAP:
+            {
+                const auto isMap = kind == InitKind::MAP;
+                if (levels.size() + 1 > options.maxDepth)
+                {
+                    return fail(Error::MAXIMUM_DEPTH_EXCEEDED);
+                }
+
+                // every item takes at least one byte, hostile counts fail without being counted down
+                const auto remaining = (uint64_t)(end - payload);
+                if (indefinite == false && (argument > remaining || (isMap && argument * 2 > remaining)))
+                {
+                    return fail(Error::UNEXPECTED_EOF);
+                }
+
+                p = payload;
+                if (indefinite)
+                {
+                    levels.push(Level{ 0, isMap, true });
+                    tagged = false;
+                    continue;
+                }
+
+                if (argument > 0)
+                {
+                    levels.push(Level{ isMap ? argument * 2 : argument, isMap, false });
+                    tagged = false;
+                    continue;
+                }
+
+                break;
+            }
+            case InitKind::SIMPLE:
+            {
+                if (argument < (uint64_t)FloatOrSimpleArgumentType::FALSE || argument > (uint64_t)FloatOrSimpleArgumentType::UNDEFINED)
+                {
+                    return fail(Error::UNSUPPORTED_SIMPLE);
+                }
+
+                p = payload;
+                break;
+            }
+            default:
+            {
+                // integers and floats
+                p = payload;
+                break;
+            }
+        }
+
+        tagged = false;
+        Detail::complete(levels);
+    } while (levels.empty() == false || tagged);
+
+    return std::make_pair(Error::OK, (size_t)(p - begin));
+}
\ No newline at end of file
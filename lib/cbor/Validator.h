@@ -0,0 +1,46 @@
+#ifndef BORON_CBOR_VALIDATOR_H_
+#define BORON_CBOR_VALIDATOR_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+#include <utility>
+
+#include "Types.h"
+#include "Decoder.h"
+
+namespace CBOR
+{
+struct ValidateOptions
+{
+    /***
+     * The maximum nesting of arrays and maps, deeper input fails with Error::MAXIMUM_DEPTH_EXCEEDED.
+     */
+    size_t maxDepth = DEFAULT_MAX_DEPTH;
+
+    /***
+     * Check that text strings (every chunk of a string of indefinite length) are valid UTF-8, invalid
+     * ones fail with Error::INVALID_UTF8.
+     */
+    bool utf8 = true;
+};
+
+/***
+ * Check that a message is well-formed without decoding it: the init bytes, the minimal encoding of all
+ * arguments, the lengths of strings and containers, the breaks of items of indefinite length, the nesting
+ * and the UTF-8 of text strings. The rules of the Decoder apply as well, i.e. a message that validates
+ * decodes without error unless an allocator is exhausted.
+ * 
+ * Nothing is allocated unless arrays and maps are nested deeper than DEFAULT_MAX_DEPTH levels.
+ * 
+ * @param data The message.
+ * @param options The checks.
+ * 
+ * @return A pair with the error and the number of bytes of the message, on error the position of the
+ *         offending item.
+ */
+std::pair<Error, size_t> validate(std::span<const uint8_t> data, const ValidateOptions& options = {});
+} // namespace CBOR
+
+#endif // BORON_CBOR_VALIDATOR_H_
\ No newline at end of file
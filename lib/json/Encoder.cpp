@@ -1,21 +1,33 @@
 #include "Encoder.h"
 
 #include <cstdint>
+#include <cstring>
 #include <climits>
 #include <cfloat>
 
+#include <algorithm>
 #include <array>
 #include <string_view>
 
+#include "../cbor/Encoding.h"
+
 using namespace std::literals;
 
 namespace
 {
+// bytes converted to hex in one window, so that large strings never need a window of their own size
+constexpr size_t MAX_HEX_BYTES_PER_WINDOW = 1024;
+
 CBOR::Error encode(std::string_view simple, OutputBuffer& buffer)
 {
     return buffer.write(std::span<const uint8_t>((const uint8_t*)simple.data(), simple.size())) ? CBOR::Error::OK : CBOR::Error::UNEXPECTED_EOF;
 }
 
+bool put(char c, OutputBuffer& buffer)
+{
+    return buffer.write((uint8_t)c);
+}
+
 CBOR::Error encodeTag(CBOR::Tag tag, OutputBuffer& buffer, JSON::Encoding encoding)
 {
     if (encoding != JSON::Encoding::EXTENDED)
@@ -37,6 +49,8 @@ CBOR::Error encodeInteger(CBOR::Item item, OutputBuffer& buffer)
 
 CBOR::Error encodeBytes(CBOR::Item item, OutputBuffer& buffer, JSON::Encoding encoding)
 {
+    const auto bytes = item.toByteString();
+
     switch (encoding)
     {
         case JSON::Encoding::STRICT:
@@ -45,84 +59,95 @@ CBOR::Error encodeBytes(CBOR::Item item, OutputBuffer& buffer, JSON::Encoding en
         }
         case JSON::Encoding::COMPAT:
         {
-            if (buffer.write('[') == false)
+            if (put('[', buffer) == false)
             {
                 return CBOR::Error::UNEXPECTED_EOF;
             }
 
-            const auto bytes = item.toByteString();
-            for (size_t i = 0; i < bytes.size(); ++i)
+            for (size_t offset = 0; offset < bytes.size(); )
             {
-                if (buffer.write('0') == false || buffer.write('x') == false)
-                {
-                    return CBOR::Error::UNEXPECTED_EOF;
-                }
-
-                const auto tmp = Bytes::toHex(bytes[i]);
-                if (buffer.write(tmp.first) == false || buffer.write(tmp.second) == false)
+                // "0xXX," per byte, the comma after the last byte is not committed
+                const auto count = std::min(bytes.size() - offset, MAX_HEX_BYTES_PER_WINDOW);
+                const auto total = count * 5;
+                const auto window = buffer.acquire(total);
+                if (window.size() < total)
                 {
                     return CBOR::Error::UNEXPECTED_EOF;
                 }
 
-                if (i + 1 < bytes.size() && buffer.write(',') == false)
+                auto* out = window.data();
+                for (auto byte : bytes.subspan(offset, count))
                 {
-                    return CBOR::Error::UNEXPECTED_EOF;
+                    const auto tmp = Bytes::toHex(byte);
+                    *(out++) = '0';
+                    *(out++) = 'x';
+                    *(out++) = tmp.first;
+                    *(out++) = tmp.second;
+                    *(out++) = ',';
                 }
-            }
 
-            if (buffer.write(']') == false)
-            {
-                return CBOR::Error::UNEXPECTED_EOF;
+                offset += count;
+                buffer.commit(offset == bytes.size() ? total - 1 : total);
             }
 
-            return CBOR::Error::OK;
+            return put(']', buffer) ? CBOR::Error::OK : CBOR::Error::UNEXPECTED_EOF;
         }
         case JSON::Encoding::EXTENDED:
         {
-            if (buffer.write('0') == false || buffer.write('x') == false)
+            if (const auto error = encode("0x"sv, buffer); error != CBOR::Error::OK)
             {
-                return CBOR::Error::UNEXPECTED_EOF;
+                return error;
             }
 
-            const auto bytes = item.toByteString();
-            for (auto byte : bytes)
+            for (size_t offset = 0; offset < bytes.size(); )
             {
-                const auto tmp = Bytes::toHex(byte);
-                if (buffer.write(tmp.first) == false || buffer.write(tmp.second) == false)
+                const auto count = std::min(bytes.size() - offset, MAX_HEX_BYTES_PER_WINDOW);
+                const auto window = buffer.acquire(count * 2);
+                if (window.size() < count * 2)
                 {
                     return CBOR::Error::UNEXPECTED_EOF;
                 }
+
+                auto* out = window.data();
+                for (auto byte : bytes.subspan(offset, count))
+                {
+                    const auto tmp = Bytes::toHex(byte);
+                    *(out++) = tmp.first;
+                    *(out++) = tmp.second;
+                }
+
+                buffer.commit(count * 2);
+                offset += count;
             }
 
             return CBOR::Error::OK;
         }
     }
+
+    return CBOR::Error::UNSUPPORTED_DATATYPE;
 }
 
 CBOR::Error encodeString(CBOR::Item item, OutputBuffer& buffer)
 {
-    if (buffer.write('"') == false)
+    const auto text = item.toTextString();
+    if (put('"', buffer) == false)
     {
         return CBOR::Error::UNEXPECTED_EOF;
     }
 
-    const auto text = item.toTextString();
-    if (const auto error = encode(std::string_view(text.data(), text.size()), buffer); error != CBOR::Error::OK)
+    // in bounded windows like the payloads of the CBOR encoder
+    const auto error = CBOR::Encoding::Detail::writePayload(buffer, std::span<const uint8_t>((const uint8_t*)text.data(), text.size()));
+    if (error != CBOR::Error::OK)
     {
         return error;
     }
 
-    if (buffer.write('"') == false)
-    {
-        return CBOR::Error::UNEXPECTED_EOF;
-    }
-
-    return CBOR::Error::OK;
+    return put('"', buffer) ? CBOR::Error::OK : CBOR::Error::UNEXPECTED_EOF;
 }
 
 CBOR::Error encodeArray(CBOR::Item item, OutputBuffer& buffer, JSON::Encoding encoding)
 {
-    if (buffer.write('[') == false)
+    if (put('[', buffer) == false)
     {
         return CBOR::Error::UNEXPECTED_EOF;
     }
@@ -134,13 +159,13 @@ CBOR::Error encodeArray(CBOR::Item item, OutputBuffer& buffer, JSON::Encoding en
             return error;
         }
 
-        if (bool(child.sibling()) && buffer.write(',') == false)
+        if (bool(child.sibling()) && put(',', buffer) == false)
         {
             return CBOR::Error::UNEXPECTED_EOF;
         }
     }
 
-    if (buffer.write(']') == false)
+    if (put(']', buffer) == false)
     {
         return CBOR::Error::UNEXPECTED_EOF;
     }
@@ -150,7 +175,7 @@ CBOR::Error encodeArray(CBOR::Item item, OutputBuffer& buffer, JSON::Encoding en
 
 CBOR::Error encodeMap(CBOR::Item item, OutputBuffer& buffer, JSON::Encoding encoding)
 {
-    if (buffer.write('{') == false)
+    if (put('{', buffer) == false)
     {
         return CBOR::Error::UNEXPECTED_EOF;
     }
@@ -168,7 +193,7 @@ CBOR::Error encodeMap(CBOR::Item item, OutputBuffer& buffer, JSON::Encoding enco
             return error;
         }
 
-        if (buffer.write(':') == false)
+        if (put(':', buffer) == false)
         {
             return CBOR::Error::UNEXPECTED_EOF;
         }
@@ -178,13 +203,13 @@ CBOR::Error encodeMap(CBOR::Item item, OutputBuffer& buffer, JSON::Encoding enco
             return error;
         }
 
-        if (bool(child.sibling()) && buffer.write(',') == false)
+        if (bool(child.sibling()) && put(',', buffer) == false)
         {
             return CBOR::Error::UNEXPECTED_EOF;
         }
     }
 
-    if (buffer.write('}') == false)
+    if (put('}', buffer) == false)
     {
         return CBOR::Error::UNEXPECTED_EOF;
     }
@@ -228,7 +253,7 @@ CBOR::Error JSON::encode(CBOR::Item root, OutputBuffer& buffer, Encoding encodin
 {
     if (root.tag() != CBOR::Tag::INVALID)
     {
-        if (buffer.write('<') == false)
+        if (put('<', buffer) == false)
         {
             return CBOR::Error::UNEXPECTED_EOF;
         }
@@ -238,7 +263,7 @@ CBOR::Error JSON::encode(CBOR::Item root, OutputBuffer& buffer, Encoding encodin
             return error;
         }
 
-        if (buffer.write(':') == false)
+        if (put(':', buffer) == false)
         {
             return CBOR::Error::UNEXPECTED_EOF;
         }
@@ -290,7 +315,7 @@ CBOR::Error JSON::encode(CBOR::Item root, OutputBuffer& buffer, Encoding encodin
         }
     }
 
-    if (root.tag() != CBOR::Tag::INVALID && buffer.write('>') == false)
+    if (root.tag() != CBOR::Tag::INVALID && put('>', buffer) == false)
     {
         return CBOR::Error::UNEXPECTED_EOF;
     }
@@ -2,9 +2,16 @@
 
 #include <cbor/CBOR.h>
 #include <json/Encoder.h>
+#include <BufferPool.h>
 
 namespace
 {
+OutputBufferPool& outputBuffers()
+{
+    static OutputBufferPool pool;
+    return pool;
+}
+
 void indent(std::string& str, uint32_t indent)
 {
     for (uint32_t i = 0; i < indent; ++i)
@@ -106,6 +113,7 @@ std::pair<CBOR::Error, std::string> Boron::decode(std::span<const uint8_t> input
         return std::make_pair(error, "");
     }
 
-    DynamicOutputBuffer buffer;
-    return std::make_pair(JSON::encode(model.root(), buffer, JSON::Encoding::EXTENDED), std::string((const char*)buffer.data(), buffer.size()));
+    auto buffer = outputBuffers().acquire();
+    const auto encodingError = JSON::encode(model.root(), *buffer, JSON::Encoding::EXTENDED);
+    return std::make_pair(encodingError, std::string((const char*)buffer->data(), buffer->size()));
 }
\ No newline at end of file
@@ -1,33 +1,79 @@
 #include <cstdlib>
 #include <cstdio>
 
+#include <optional>
 #include <span>
 #include <vector>
 #include <string>
 #include <string_view>
+
+#if !defined(BORON_HAS_MMAP)
 #include <fstream>
+#endif
 
 #include "cbor/CBOR.h"
 #include "Functions.h"
 
 namespace
 {
-std::vector<uint8_t> parseBytesOrLoadFile(std::string_view arg)
+#if defined(BORON_HAS_MMAP)
+using InputFile = MappedFile;
+#else
+/***
+ * A file read into memory where it cannot be mapped.
+ */
+class InputFile
+{
+public:
+    bool open(std::string_view path)
+    {
+        std::ifstream file(std::string(path), std::ios::binary | std::ios::ate);
+        if (file.is_open() == false)
+        {
+            return false;
+        }
+
+        _data.resize((size_t)file.tellg());
+        file.seekg(0, std::ios::beg);
+
+        return bool(file.read((char*)_data.data(), _data.size()));
+    }
+
+    std::span<const uint8_t> data() const
+    {
+        return _data;
+    }
+
+private:
+    std::vector<uint8_t> _data;
+};
+#endif // BORON_HAS_MMAP
+
+/***
+ * Parse the argument as hex string or load the file it names. Files are mapped and decoded in place
+ * where the platform supports it.
+ * 
+ * @param arg The hex string (prefixed with "0x") or the path of the file.
+ * @param bytes Storage for the parsed bytes.
+ * @param file Storage for the loaded file.
+ * 
+ * @return The input bytes, valid as long as @p bytes and @p file live, nothing if the file cannot be opened.
+ */
+std::optional<std::span<const uint8_t>> parseBytesOrLoadFile(std::string_view arg, std::vector<uint8_t>& bytes, InputFile& file)
 {
     if (arg.starts_with("0x"))
     {
-        return Bytes::parseBytes(arg.substr(2));
+        bytes = Bytes::parseBytes(arg.substr(2));
+        return std::span<const uint8_t>(bytes);
     }
-    
-    std::ifstream file(arg, std::ios::binary);
-    file.seekg (0, std::ios::end);
-    const auto length = file.tellg();
-    file.seekg (0, std::ios::beg);
 
-    std::vector<uint8_t> out(length);
-    file.read((char*)out.data(), length);
+    if (file.open(arg) == false)
+    {
+        printf("Error: cannot open %.*s\n", (int)arg.size(), arg.data());
+        return std::nullopt;
+    }
 
-    return out;
+    return file.data();
 }
 
 int help()
@@ -70,8 +116,15 @@ int main(int argc, const char* argv[])
             packed = true;
         }
 
-        const auto bytes = parseBytesOrLoadFile(args.back());
-        const auto [error, str] = Boron::decode(bytes, packed ? Boron::StringFormat::PACKED : Boron::StringFormat::INDENTED);
+        std::vector<uint8_t> storage;
+        InputFile file;
+        const auto bytes = parseBytesOrLoadFile(args.back(), storage, file);
+        if (bytes.has_value() == false)
+        {
+            return EXIT_FAILURE;
+        }
+
+        const auto [error, str] = Boron::decode(*bytes, packed ? Boron::StringFormat::PACKED : Boron::StringFormat::INDENTED);
         if (error != CBOR::Error::OK)
         {
             printf("Error: %s\n", CBOR::toString(error));
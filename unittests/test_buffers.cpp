@@ -0,0 +1,396 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <array>
+#include <string_view>
+#include <thread>
+
+#include <cbor/Encoding.h>
+#include <cbor/Decoding.h>
+#include <cbor/Decoder.h>
+#include <cbor/Encoder.h>
+#include <json/Encoder.h>
+#include "cbor/DataModel.h"
+#include "Buffers.h"
+#include "BufferPool.h"
+
+using namespace std::literals;
+
+TEST(Buffers, SpanInputBuffer_MarkRewindSlice)
+{
+    // 24(h'8201'), 7
+    static constexpr std::array<uint8_t, 6> TEST_DATA = { 0xd8, 0x18, 0x42, 0x82, 0x01, 0x07 };
+
+    SpanInputBuffer buffer(TEST_DATA);
+
+    // speculatively decode the tag and rewind
+    const auto mark = buffer.mark();
+    {
+        const auto [error, header] = CBOR::Decoding::decode(buffer);
+        ASSERT_EQ(error, CBOR::Error::OK);
+        EXPECT_EQ(header.majorType(), CBOR::MajorType::TAGGED);
+        EXPECT_EQ(buffer.size(), 2);
+    }
+    buffer.rewind(mark);
+    EXPECT_EQ(buffer.size(), 0);
+    EXPECT_EQ(buffer.peek(), 0xd8);
+
+    // carve out the tag and byte string header and the embedded item
+    auto head = buffer.slice(3);
+    ASSERT_EQ(head.capacity(), 3);
+    auto embedded = buffer.slice(2);
+    ASSERT_EQ(embedded.capacity(), 2);
+    EXPECT_EQ(buffer.remaining(), 1);
+
+    {
+        const auto [error, header] = CBOR::Decoding::decode(embedded);
+        ASSERT_EQ(error, CBOR::Error::OK);
+        EXPECT_EQ(header.majorType(), CBOR::MajorType::ARRAY);
+        EXPECT_EQ(header.argument(), 2);
+
+        // the child is bounded, the parent's remaining byte is not visible
+        EXPECT_EQ(CBOR::Decoding::decode(embedded).first, CBOR::Error::OK);
+        EXPECT_EQ(CBOR::Decoding::decode(embedded).first, CBOR::Error::UNEXPECTED_EOF);
+    }
+
+    EXPECT_EQ(buffer.slice(2).capacity(), 0);
+    EXPECT_EQ(buffer.peek(), 0x07);
+}
+
+TEST(Buffers, SpanOutputBuffer_AcquireCommit)
+{
+    std::array<uint8_t, 4> data{};
+    SpanOutputBuffer buffer(data);
+
+    auto window = buffer.acquire(3);
+    ASSERT_GE(window.size(), 3);
+    window[0] = 0x01;
+    window[1] = 0x02;
+    buffer.commit(2);
+    EXPECT_EQ(buffer.size(), 2);
+
+    // only two bytes are left
+    EXPECT_TRUE(buffer.acquire(3).empty());
+    EXPECT_EQ(buffer.acquire(2).size(), 2);
+    EXPECT_TRUE(buffer.write(std::array<uint8_t, 2>{0x03, 0x04}));
+    EXPECT_EQ(buffer.size(), 4);
+    EXPECT_FALSE(buffer.write((uint8_t)0x05));
+
+    EXPECT_EQ(data, (std::array<uint8_t, 4>{0x01, 0x02, 0x03, 0x04}));
+}
+
+TEST(Buffers, DynamicOutputBuffer_AcquireCommit)
+{
+    DynamicOutputBuffer buffer;
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        auto window = buffer.acquire(3);
+        ASSERT_GE(window.size(), 3);
+        window[0] = (uint8_t)i;
+        window[1] = (uint8_t)(i >> 8);
+        buffer.commit(2);
+    }
+
+    ASSERT_EQ(buffer.size(), 2000);
+    EXPECT_GE(buffer.capacity(), buffer.size());
+    EXPECT_EQ(buffer.data()[2 * 999], (uint8_t)999);
+    EXPECT_EQ(buffer.data()[2 * 999 + 1], (uint8_t)(999 >> 8));
+}
+
+TEST(Buffers, DynamicOutputBuffer_Encoding)
+{
+    constexpr auto TEXT = "Hello World"sv;
+
+    DynamicOutputBuffer buffer;
+    ASSERT_EQ(CBOR::Encoding::encode(buffer, TEXT), CBOR::Error::OK);
+    ASSERT_EQ(CBOR::Encoding::encode(buffer, INT64_C(0x123456789)), CBOR::Error::OK);
+
+    ASSERT_EQ(buffer.size(), 1 + TEXT.size() + 9);
+    EXPECT_EQ(buffer.data()[0], 0x6b);
+    EXPECT_EQ(std::string_view((const char*)buffer.data() + 1, TEXT.size()), TEXT);
+    EXPECT_EQ(buffer.data()[TEXT.size() + 1], 0x1b);
+    EXPECT_EQ(buffer.data()[TEXT.size() + 6], 0x23);
+    EXPECT_EQ(buffer.data()[TEXT.size() + 9], 0x89);
+}
+
+TEST(Buffers, DynamicOutputBuffer_JSON)
+{
+    CBOR::DynamicDataModel model;
+    auto root = model.createEmpty(CBOR::Type::ARRAY);
+    ASSERT_TRUE(bool(root));
+    ASSERT_TRUE(bool(root.addChild(CBOR::Type::INTEGER, CBOR::Integer(1))));
+    ASSERT_TRUE(bool(root.addChild(CBOR::Type::INTEGER, CBOR::Integer(23))));
+
+    DynamicOutputBuffer buffer;
+    ASSERT_EQ(JSON::encode(model.root(), buffer), CBOR::Error::OK);
+    EXPECT_EQ(std::string_view((const char*)buffer.data(), buffer.size()), "[1,23]"sv);
+}
+
+#if defined(BORON_HAS_MMAP)
+TEST(Buffers, MmapInputBuffer)
+{
+    // [1, [2, 3], "abc"]
+    static constexpr std::array<uint8_t, 8> TEST_DATA = { 0x83, 0x01, 0x82, 0x02, 0x03, 0x63, 'a', 'b' };
+    static constexpr std::array<uint8_t, 1> TEST_DATA_TAIL = { 'c' };
+
+    const auto path = testing::TempDir() + "boron_mmap_test.cbor";
+    {
+        auto* file = fopen(path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        fwrite(TEST_DATA.data(), 1, TEST_DATA.size(), file);
+        fwrite(TEST_DATA_TAIL.data(), 1, TEST_DATA_TAIL.size(), file);
+        fclose(file);
+    }
+
+    // Decode the tree directly from the mapping
+    {
+        MappedFile file;
+        ASSERT_TRUE(file.open(path));
+        ASSERT_EQ(file.size(), TEST_DATA.size() + TEST_DATA_TAIL.size());
+
+        CBOR::DynamicDataModel model;
+        const auto [error, length] = CBOR::decode(model, file.data());
+        ASSERT_EQ(error, CBOR::Error::OK);
+        EXPECT_EQ(length, file.size());
+        EXPECT_EQ(model.root().size(), 3);
+    }
+
+    // Decode the headers with the buffer
+    {
+        MmapInputBuffer buffer;
+        ASSERT_TRUE(buffer.open(path));
+
+        const auto [error, header] = CBOR::Decoding::decode(buffer);
+        ASSERT_EQ(error, CBOR::Error::OK);
+        EXPECT_EQ(header.majorType(), CBOR::MajorType::ARRAY);
+        EXPECT_EQ(header.argument(), 3);
+        EXPECT_EQ(buffer.size(), 1);
+        EXPECT_EQ(buffer.data().data()[0], 0x83);
+    }
+
+    MappedFile missing;
+    EXPECT_FALSE(missing.open(path + ".missing"));
+    EXPECT_TRUE(missing.data().empty());
+
+    remove(path.c_str());
+}
+#endif // BORON_HAS_MMAP
+
+#if defined(BORON_HAS_POSIX_IO)
+TEST(Buffers, FileOutputBuffer)
+{
+    CBOR::DynamicDataModel model;
+    auto root = model.createEmpty(CBOR::Type::ARRAY);
+    ASSERT_TRUE(bool(root));
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(bool(root.addChild(CBOR::Type::INTEGER, CBOR::Integer(i * 1000))));
+    }
+
+    DynamicOutputBuffer expected;
+    ASSERT_EQ(CBOR::encode(model, expected).first, CBOR::Error::OK);
+
+    const auto path = testing::TempDir() + "boron_file_output_test.cbor";
+    const auto fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+
+    // a tiny block forces flushes in the middle of items and direct writes bypassing the block
+    const std::vector<uint8_t> large(100, 0xab);
+    {
+        FileOutputBuffer buffer(fd, 16);
+
+        const auto [error, length] = CBOR::encode(model, buffer);
+        ASSERT_EQ(error, CBOR::Error::OK);
+        EXPECT_EQ(length, expected.size());
+
+        EXPECT_TRUE(buffer.write(large));
+        EXPECT_EQ(buffer.size(), expected.size() + large.size());
+    }
+    close(fd);
+
+    MappedFile file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_EQ(file.size(), expected.size() + large.size());
+    EXPECT_TRUE(std::equal(expected.data(), expected.data() + expected.size(), file.data().begin()));
+    EXPECT_TRUE(std::equal(large.begin(), large.end(), file.data().begin() + expected.size()));
+
+    CBOR::DynamicDataModel decoded;
+    const auto [error, length] = CBOR::decode(decoded, file.data());
+    ASSERT_EQ(error, CBOR::Error::OK);
+    EXPECT_EQ(length, expected.size());
+    ASSERT_EQ(decoded.root().size(), 100);
+    EXPECT_EQ(decoded.root()[99].toInt(), 99000);
+
+    remove(path.c_str());
+
+    // nothing is accepted after a failed write, although the block has room left
+    FileOutputBuffer invalid(-1, 16);
+    EXPECT_FALSE(invalid.write(large));
+    EXPECT_TRUE(invalid.failed());
+    EXPECT_FALSE(invalid.write(uint8_t(0x01)));
+    EXPECT_TRUE(invalid.acquire(1).empty());
+    EXPECT_EQ(invalid.size(), 0);
+}
+
+TEST(Buffers, FileOutputBuffer_JSON)
+{
+    // [h'00 01 02 ...' (100000 bytes), "aaa..." (100000 characters)]
+    std::vector<uint8_t> message = { 0x82, 0x5a, 0x00, 0x01, 0x86, 0xa0 };
+    for (size_t i = 0; i < 100000; ++i)
+    {
+        message.push_back(uint8_t(i));
+    }
+
+    message.insert(message.end(), { 0x7a, 0x00, 0x01, 0x86, 0xa0 });
+    message.resize(message.size() + 100000, 'a');
+
+    CBOR::DynamicDataModel model;
+    ASSERT_EQ(CBOR::decode(model, message).first, CBOR::Error::OK);
+
+    const auto path = testing::TempDir() + "boron_file_output_test.json";
+    for (const auto encoding : { JSON::Encoding::COMPAT, JSON::Encoding::EXTENDED })
+    {
+        DynamicOutputBuffer expected;
+        ASSERT_EQ(JSON::encode(model.root(), expected, encoding), CBOR::Error::OK);
+
+        const auto fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ASSERT_GE(fd, 0);
+
+        // large strings are written in pieces, the block never grows with them and shrinks back
+        {
+            FileOutputBuffer buffer(fd, 16);
+            ASSERT_EQ(JSON::encode(model.root(), buffer, encoding), CBOR::Error::OK);
+            EXPECT_LE(buffer.blockSize(), 8 * 1024);
+            ASSERT_TRUE(buffer.flush());
+            EXPECT_EQ(buffer.blockSize(), 16);
+        }
+        close(fd);
+
+        MappedFile file;
+        ASSERT_TRUE(file.open(path));
+        ASSERT_EQ(file.size(), expected.size());
+        EXPECT_TRUE(std::equal(expected.data(), expected.data() + expected.size(), file.data().begin()));
+    }
+
+    // the separators of the hex bytes
+    static constexpr std::array<uint8_t, 3> SHORT = { 0x42, 0x01, 0x02 };
+    ASSERT_EQ(CBOR::decode(model, SHORT).first, CBOR::Error::OK);
+    DynamicOutputBuffer compat;
+    ASSERT_EQ(JSON::encode(model.root(), compat, JSON::Encoding::COMPAT), CBOR::Error::OK);
+    EXPECT_EQ(std::string_view((const char*)compat.data(), compat.size()), "[0x01,0x02]"sv);
+
+    DynamicOutputBuffer extended;
+    ASSERT_EQ(JSON::encode(model.root(), extended, JSON::Encoding::EXTENDED), CBOR::Error::OK);
+    EXPECT_EQ(std::string_view((const char*)extended.data(), extended.size()), "0x0102"sv);
+
+    remove(path.c_str());
+}
+#endif // BORON_HAS_POSIX_IO
+
+TEST(Buffers, SegmentedOutputBuffer)
+{
+    constexpr auto TEXT = "a text string that is longer than a single chunk"sv;
+
+    ChunkPool pool(16);
+
+    DynamicOutputBuffer expected;
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(CBOR::Encoding::encode(expected, i * 1000), CBOR::Error::OK);
+    }
+    ASSERT_EQ(CBOR::Encoding::encode(expected, TEXT), CBOR::Error::OK);
+
+    for (int round = 0; round < 2; ++round)
+    {
+        SegmentedOutputBuffer buffer(pool);
+        for (int64_t i = 0; i < 100; ++i)
+        {
+            ASSERT_EQ(CBOR::Encoding::encode(buffer, i * 1000), CBOR::Error::OK);
+        }
+        ASSERT_EQ(CBOR::Encoding::encode(buffer, TEXT), CBOR::Error::OK);
+
+        ASSERT_EQ(buffer.size(), expected.size());
+        EXPECT_GT(buffer.segments().size(), 1);
+
+        const auto flat = buffer.flatten();
+        EXPECT_TRUE(std::equal(flat.begin(), flat.end(), expected.data()));
+
+        size_t total = 0;
+        for (const auto& segment : buffer.segments())
+        {
+            total += segment.size();
+        }
+        EXPECT_EQ(total, expected.size());
+
+#if defined(BORON_HAS_POSIX_IO)
+        total = 0;
+        for (const auto& iov : buffer.iovecs())
+        {
+            total += iov.iov_len;
+        }
+        EXPECT_EQ(total, expected.size());
+#endif // BORON_HAS_POSIX_IO
+
+        // the second round is served from the chunks released by the first
+        const auto idle = pool.size();
+        buffer.clear();
+        EXPECT_EQ(buffer.size(), 0);
+        EXPECT_GT(pool.size(), idle);
+    }
+}
+
+TEST(Buffers, OutputBufferPool)
+{
+    OutputBufferPool pool(1024);
+
+    const uint8_t* data = nullptr;
+    {
+        auto buffer = pool.acquire();
+        ASSERT_EQ(CBOR::Encoding::encode(*buffer, "Hello World"sv), CBOR::Error::OK);
+        EXPECT_EQ(buffer->size(), 12);
+        data = buffer->data();
+    }
+
+    // the buffer comes back empty but with its memory
+    ASSERT_EQ(pool.size(), 1);
+    {
+        auto buffer = pool.acquire();
+        EXPECT_EQ(pool.size(), 0);
+        EXPECT_EQ(buffer->size(), 0);
+        EXPECT_EQ(buffer->data(), data);
+
+        // grow it beyond the high-water mark
+        const std::vector<uint8_t> large(4096, 0);
+        ASSERT_EQ(CBOR::Encoding::encode(*buffer, large), CBOR::Error::OK);
+        EXPECT_GT(buffer->capacity(), pool.highWaterMark());
+    }
+
+    {
+        auto buffer = pool.acquire();
+        EXPECT_LE(buffer->capacity(), pool.highWaterMark());
+    }
+
+    // concurrent leases
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&pool]()
+        {
+            for (int64_t j = 0; j < 1000; ++j)
+            {
+                auto buffer = pool.acquire();
+                EXPECT_EQ(CBOR::Encoding::encode(*buffer, j), CBOR::Error::OK);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_GE(pool.size(), 1);
+    EXPECT_LE(pool.size(), 4);
+}
\ No newline at end of file
@@ -1,9 +1,19 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 #include <cbor/Decoder.h>
 #include <cbor/Encoder.h>
+#include <cbor/EventDecoder.h>
+#include <cbor/Measure.h>
+#include <cbor/Path.h>
+#include <cbor/Reader.h>
+#include <cbor/Sequence.h>
+#include <cbor/Validator.h>
 #include "Bytes.h"
 
 using namespace Bytes::Literals;
@@ -75,4 +85,1028 @@ TEST(CBOR, Encoder)
     const CBOR::InitByte intInit(data[1]);
     EXPECT_EQ(intInit.majorType(), CBOR::MajorType::UNSIGNED_INT);
     EXPECT_EQ(intInit.argument(), 1);
+}
+
+TEST(CBOR, Decoder_Feed)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    CBOR::DynamicDataModel expected;
+    ASSERT_EQ(CBOR::decode(expected, TEST_DATA).first, CBOR::Error::OK);
+    const auto expectedString = expected.root().toString();
+
+    // feed the message in chunks of every possible size
+    for (size_t chunk = 1; chunk <= TEST_DATA.size(); ++chunk)
+    {
+        CBOR::DynamicDataModel model;
+        CBOR::Decoder decoder(model);
+
+        size_t offset = 0;
+        auto result = std::make_pair(CBOR::Error::UNEXPECTED_EOF, size_t(0));
+        while (offset < TEST_DATA.size())
+        {
+            const auto n = std::min(chunk, TEST_DATA.size() - offset);
+            result = decoder.feed(std::span<const uint8_t>(TEST_DATA.data() + offset, n));
+            ASSERT_TRUE(result.first == CBOR::Error::OK || result.first == CBOR::Error::UNEXPECTED_EOF);
+            ASSERT_EQ(result.second, n);
+
+            offset += n;
+
+            // the partially decoded model is available as soon as the root was decoded
+            EXPECT_TRUE(bool(model.root()));
+        }
+
+        ASSERT_EQ(result.first, CBOR::Error::OK);
+        ASSERT_TRUE(decoder.complete());
+        EXPECT_EQ(model.root().toString(), expectedString);
+        EXPECT_EQ(model.root()[2].tag(), CBOR::Tag::DATE_TIME_STRING);
+    }
+}
+
+TEST(CBOR, Decoder_Feed_Errors)
+{
+    CBOR::DynamicDataModel model;
+    CBOR::Decoder decoder(model);
+
+    // two messages in one chunk: only the first one is consumed
+    static constexpr auto TWO_MESSAGES = 0x820102_bytes;
+    {
+        const auto [error, length] = decoder.feed(std::span<const uint8_t>(TWO_MESSAGES.data(), 2));
+        EXPECT_EQ(error, CBOR::Error::UNEXPECTED_EOF);
+        EXPECT_EQ(length, 2);
+    }
+
+    {
+        static constexpr auto REST = 0x020a_bytes;
+        const auto [error, length] = decoder.feed(REST);
+        EXPECT_EQ(error, CBOR::Error::OK);
+        EXPECT_EQ(length, 1);
+        EXPECT_EQ(model.root().size(), 2);
+    }
+
+    // a map key must be a string or an integer
+    decoder.reset();
+    static constexpr auto ARRAY_KEY = 0xa18001_bytes;
+    EXPECT_EQ(decoder.feed(ARRAY_KEY).first, CBOR::Error::UNSUPPORTED_KEY_TYPE);
+
+    decoder.reset();
+    static constexpr auto DOUBLE_TAGGED = 0xc1c101_bytes;
+    EXPECT_EQ(decoder.feed(DOUBLE_TAGGED).first, CBOR::Error::DOUBLE_TAGGED);
+
+    // a length that could never be buffered fails instead of wrapping the number of bytes needed, also if
+    // the header is cut off
+    static constexpr auto HOSTILE_LENGTH = 0x5bffffffffffffffff0102_bytes;
+    decoder.reset();
+    EXPECT_EQ(decoder.feed(HOSTILE_LENGTH).first, CBOR::Error::STRING_TOO_LONG);
+
+    decoder.reset();
+    EXPECT_EQ(decoder.feed(std::span<const uint8_t>(HOSTILE_LENGTH).first(3)), std::make_pair(CBOR::Error::UNEXPECTED_EOF, size_t(3)));
+    EXPECT_EQ(decoder.feed(std::span<const uint8_t>(HOSTILE_LENGTH).subspan(3)).first, CBOR::Error::STRING_TOO_LONG);
+
+    static constexpr auto HOSTILE_CHUNK = 0x5f5bffffffffffffffff0102_bytes;
+    decoder.reset();
+    EXPECT_EQ(decoder.feed(HOSTILE_CHUNK).first, CBOR::Error::STRING_TOO_LONG);
+    EXPECT_EQ(CBOR::decode(model, HOSTILE_CHUNK).first, CBOR::Error::STRING_TOO_LONG);
+}
+
+TEST(CBOR, Decoder_Deep)
+{
+    // [[[...[]...]]] nested far deeper than any recursive decoder could handle
+    constexpr size_t DEPTH = 100000;
+    std::vector<uint8_t> data(DEPTH, 0x81);
+    data.back() = 0x80;
+
+    {
+        CBOR::DynamicDataModel model;
+        CBOR::Decoder decoder(model, DEPTH);
+        const auto [error, length] = decoder.decode(data);
+        ASSERT_EQ(error, CBOR::Error::OK);
+        EXPECT_EQ(length, DEPTH);
+
+        size_t depth = 1;
+        for (auto item = model.root(); item.size() > 0; item = item[0])
+        {
+            ++depth;
+        }
+
+        EXPECT_EQ(depth, DEPTH);
+    }
+
+    {
+        CBOR::DynamicDataModel model;
+        CBOR::Decoder decoder(model, DEPTH - 1);
+        EXPECT_EQ(decoder.decode(data).first, CBOR::Error::MAXIMUM_DEPTH_EXCEEDED);
+    }
+
+    {
+        CBOR::DynamicDataModel model;
+        EXPECT_EQ(CBOR::decode(model, data).first, CBOR::Error::MAXIMUM_DEPTH_EXCEEDED);
+    }
+}
+
+namespace
+{
+// records the events as a compact, JSON-like string
+class RecordingHandler : public CBOR::EventHandler
+{
+public:
+    void onInt(int64_t value) { separate(); events += std::to_string(value); }
+
+    void onFloat(CBOR::Float value) { separate(); events += std::to_string(value); }
+
+    void onBool(CBOR::Boolean value) { separate(); events += value ? "true" : "false"; }
+
+    void onNull() { separate(); events += "null"; }
+
+    void onBytes(std::span<const uint8_t> bytes) { separate(); events += "h'" + Bytes::bytesToString(bytes) + "'"; }
+
+    void onText(std::string_view text) { separate(); events += "\"" + std::string(text) + "\""; }
+
+    void onArrayBegin(uint64_t) { separate(); events += "["; }
+
+    void onArrayEnd() { events += "]"; }
+
+    void onMapBegin(uint64_t) { separate(); events += "{"; }
+
+    void onMapEnd() { events += "}"; }
+
+    void onMapKey(int64_t key) { separate(); events += std::to_string(key) + ":"; }
+
+    void onMapKey(std::string_view key) { separate(); events += std::string(key) + ":"; }
+
+    void onTag(CBOR::Tag tag) { separate(); events += std::to_string((uint64_t)tag) + "("; }
+
+    std::string events;
+
+private:
+    void separate()
+    {
+        if (events.empty() == false && events.back() != '[' && events.back() != '{' && events.back() != ':' && events.back() != '(')
+        {
+            events += ",";
+        }
+    }
+};
+} // namespace
+
+TEST(CBOR, EventDecoder)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    RecordingHandler handler;
+    const auto [error, length] = CBOR::decodeEvents(TEST_DATA, handler);
+    ASSERT_EQ(error, CBOR::Error::OK);
+    EXPECT_EQ(length, TEST_DATA.size());
+    EXPECT_EQ(handler.events, "{a:[1,1000,-2],24:h'0102',text:0(\"2013-03-21\",n:[null,true,{}]}");
+
+    // 1.5 as a single-precision float followed by a second message
+    static constexpr auto FLOAT = 0xfa3fc0000001_bytes;
+    RecordingHandler floats;
+    EXPECT_EQ(CBOR::decodeEvents(FLOAT, floats), std::make_pair(CBOR::Error::OK, size_t(5)));
+    EXPECT_EQ(floats.events, "1.500000");
+
+    // the stack is bounded, deeper input is rejected
+    static constexpr auto NESTED = 0x8181818100_bytes;
+    RecordingHandler nested;
+    CBOR::EventDecoder<RecordingHandler, 3> decoder(nested);
+    EXPECT_EQ(decoder.decode(NESTED).first, CBOR::Error::MAXIMUM_DEPTH_EXCEEDED);
+
+    static constexpr auto ARRAY_KEY = 0xa18001_bytes;
+    EXPECT_EQ(CBOR::decodeEvents(ARRAY_KEY, nested).first, CBOR::Error::UNSUPPORTED_KEY_TYPE);
+
+    static constexpr auto TRUNCATED = 0x830102_bytes;
+    EXPECT_EQ(CBOR::decodeEvents(TRUNCATED, nested).first, CBOR::Error::UNEXPECTED_EOF);
+
+    // reserved arguments and two-byte simples below 32 are malformed
+    static constexpr auto RESERVED = 0x1c_bytes;
+    EXPECT_EQ(CBOR::decodeEvents(RESERVED, nested).first, CBOR::Error::MALFORMED_MESSAGE);
+
+    static constexpr auto SHORT_SIMPLE = 0xf814_bytes;
+    EXPECT_EQ(CBOR::decodeEvents(SHORT_SIMPLE, nested).first, CBOR::Error::MALFORMED_ARGUMENT);
+}
+
+TEST(CBOR, Reader)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    CBOR::Reader reader(TEST_DATA);
+    EXPECT_EQ(reader.peekType(), std::make_pair(CBOR::Error::OK, CBOR::Type::MAP));
+
+    const auto [error, pairs] = reader.enterContainer();
+    ASSERT_EQ(error, CBOR::Error::OK);
+    ASSERT_EQ(pairs, 4);
+
+    // jump to "text" without looking at the other values
+    std::string_view text;
+    for (uint64_t i = 0; i < pairs; ++i)
+    {
+        if (reader.peekType().second == CBOR::Type::INTEGER)
+        {
+            EXPECT_EQ(reader.readInt(), std::make_pair(CBOR::Error::OK, INT64_C(24)));
+            ASSERT_EQ(reader.skip(), CBOR::Error::OK);
+            continue;
+        }
+
+        const auto key = reader.readText();
+        ASSERT_EQ(key.first, CBOR::Error::OK);
+
+        if (key.second == "text")
+        {
+            // a failed typed read does not move the cursor
+            EXPECT_EQ(reader.readInt().first, CBOR::Error::UNEXPECTED_TYPE);
+
+            const auto value = reader.readText();
+            ASSERT_EQ(value.first, CBOR::Error::OK);
+            EXPECT_EQ(reader.tag(), CBOR::Tag::DATE_TIME_STRING);
+            text = value.second;
+        }
+        else
+        {
+            ASSERT_EQ(reader.skip(), CBOR::Error::OK);
+        }
+    }
+
+    EXPECT_EQ(text, "2013-03-21");
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_EQ(reader.position(), TEST_DATA.size());
+
+    // typed getters
+    static constexpr auto VALUES = 0x85f5f6fa3fc0000029a0_bytes;
+    CBOR::Reader values(VALUES);
+    EXPECT_EQ(values.enterContainer(), std::make_pair(CBOR::Error::OK, UINT64_C(5)));
+    EXPECT_EQ(values.readBool(), std::make_pair(CBOR::Error::OK, true));
+    EXPECT_EQ(values.readNull(), CBOR::Error::OK);
+    EXPECT_EQ(values.readFloat(), std::make_pair(CBOR::Error::OK, 1.5));
+    EXPECT_EQ(values.readInt(), std::make_pair(CBOR::Error::OK, INT64_C(-10)));
+    EXPECT_EQ(values.enterContainer(), std::make_pair(CBOR::Error::OK, UINT64_C(0)));
+    EXPECT_TRUE(values.atEnd());
+
+    // declared lengths beyond the message fail without being counted down
+    static constexpr auto HUGE = 0x9bffffffffffffffff01_bytes;
+    CBOR::Reader huge(HUGE);
+    EXPECT_EQ(huge.skip(), CBOR::Error::UNEXPECTED_EOF);
+    EXPECT_EQ(huge.enterContainer().first, CBOR::Error::UNEXPECTED_EOF);
+    EXPECT_EQ(huge.position(), 0);
+
+    // containers of indefinite length nested deeper than the inline levels, with a map among them that
+    // must not end after a key
+    std::vector<uint8_t> nested(100, 0x9f);
+    nested.insert(nested.end(), { 0xbf, 0x01, 0x02, 0xff });
+    nested.insert(nested.end(), 100, 0xff);
+    CBOR::Reader deep(nested);
+    EXPECT_EQ(deep.skip(), CBOR::Error::OK);
+    EXPECT_TRUE(deep.atEnd());
+
+    nested[102] = 0xff;
+    CBOR::Reader odd(nested);
+    EXPECT_EQ(odd.skip(), CBOR::Error::MALFORMED_MESSAGE);
+    EXPECT_EQ(odd.position(), 0);
+}
+
+TEST(CBOR, Decoder_Lazy)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    CBOR::DynamicDataModel expected;
+    ASSERT_EQ(CBOR::decode(expected, TEST_DATA).first, CBOR::Error::OK);
+
+    CBOR::DynamicDataModel model;
+    const auto [error, length] = CBOR::decode(model, TEST_DATA, CBOR::DecodeOptions{ .lazy = true });
+    ASSERT_EQ(error, CBOR::Error::OK);
+    EXPECT_EQ(length, TEST_DATA.size());
+
+    // only the root exists, its size is taken from the encoding
+    auto root = model.root();
+    EXPECT_TRUE(root.isLazy());
+    EXPECT_EQ(root.size(), 4);
+    EXPECT_EQ(model.itemAllocator().size(), 1);
+
+    // accessing a child decodes one level, nested containers stay lazy
+    auto first = root[0];
+    EXPECT_FALSE(root.isLazy());
+    EXPECT_EQ(model.itemAllocator().size(), 9);
+    ASSERT_TRUE(first.isLazy());
+    EXPECT_EQ(first[1].toInt(), 1000);
+    EXPECT_EQ(root[2].tag(), CBOR::Tag::DATE_TIME_STRING);
+    EXPECT_TRUE(root[3].isLazy());
+
+    // untouched containers are encoded as they were decoded
+    std::array<uint8_t, TEST_DATA.size()> encoded{0};
+    const auto encodedResult = CBOR::encode(model, encoded);
+    ASSERT_EQ(encodedResult, std::make_pair(CBOR::Error::OK, TEST_DATA.size()));
+    EXPECT_EQ(encoded, TEST_DATA);
+
+    EXPECT_EQ(model.root().toString(), expected.root().toString());
+    EXPECT_EQ(model.error(), CBOR::Error::OK);
+
+    // errors inside a lazy container are reported once it is accessed
+    static constexpr auto BAD_KEY = 0x81a18001_bytes;
+    CBOR::DynamicDataModel bad;
+    ASSERT_EQ(CBOR::decode(bad, BAD_KEY, CBOR::DecodeOptions{ .lazy = true }).first, CBOR::Error::OK);
+    EXPECT_FALSE(bool(bad.root()[0].begin()));
+    EXPECT_EQ(bad.error(), CBOR::Error::UNSUPPORTED_KEY_TYPE);
+
+    // a container whose children fail leaves no partial list behind
+    static constexpr auto BAD_STRING = 0x8183010261ff_bytes;
+    CBOR::DynamicDataModel partial;
+    ASSERT_EQ(CBOR::decode(partial, BAD_STRING, CBOR::DecodeOptions{ .lazy = true, .validateUtf8 = true }).first, CBOR::Error::OK);
+    auto inner = partial.root().begin();
+    ASSERT_TRUE(inner.isLazy());
+    EXPECT_FALSE(bool(inner.begin()));
+    EXPECT_EQ(inner.size(), 0);
+    EXPECT_EQ(partial.error(), CBOR::Error::INVALID_UTF8);
+
+    // lazy containers are nested within the limit of the message
+    std::vector<uint8_t> deep(2000, 0x81);
+    deep.back() = 0x80;
+    CBOR::DynamicDataModel nested;
+    ASSERT_EQ(CBOR::decode(nested, deep, CBOR::DecodeOptions{ .maxDepth = 10, .lazy = true }).first, CBOR::Error::OK);
+    size_t levels = 0;
+    for (auto item = nested.root(); bool(item); item = item.begin())
+    {
+        ++levels;
+    }
+    EXPECT_EQ(levels, 10);
+    EXPECT_EQ(nested.error(), CBOR::Error::MAXIMUM_DEPTH_EXCEEDED);
+}
+
+TEST(CBOR, Decoder_Borrow)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    CBOR::DynamicDataModel expected;
+    ASSERT_EQ(CBOR::decode(expected, TEST_DATA).first, CBOR::Error::OK);
+    const auto expectedString = expected.root().toString();
+
+    for (const auto lazy : { false, true })
+    {
+        std::vector<uint8_t> input(TEST_DATA.begin(), TEST_DATA.end());
+        const auto contains = [&](const void* p)
+        {
+            return p >= (const void*)input.data() && p < (const void*)(input.data() + input.size());
+        };
+
+        CBOR::DynamicDataModel model;
+        ASSERT_EQ(CBOR::decode(model, input, CBOR::DecodeOptions{ .lazy = lazy, .borrow = true }).first, CBOR::Error::OK);
+        EXPECT_EQ(model.source().data(), input.data());
+
+        // strings are views into the input, nothing was copied
+        auto text = model.root()[2];
+        ASSERT_TRUE(text.isBorrowed());
+        EXPECT_TRUE(contains(text.toTextString().data()));
+        EXPECT_TRUE(contains(model.root()[1].toByteString().data()));
+        EXPECT_TRUE(contains(model.root()[0].key().toTextString().data()));
+        EXPECT_EQ(model.blobAllocator().size(), 0);
+
+        // after detaching the input can be released
+        ASSERT_EQ(model.detach(), CBOR::Error::OK);
+        EXPECT_TRUE(model.source().empty());
+        EXPECT_FALSE(text.isBorrowed());
+        EXPECT_FALSE(model.root()[3].isLazy());
+        EXPECT_FALSE(contains(text.toTextString().data()));
+
+        std::fill(input.begin(), input.end(), 0xff);
+        EXPECT_EQ(model.root().toString(), expectedString);
+    }
+}
+
+TEST(CBOR, Decoder_Indefinite)
+{
+    // {_ "a": [_ 1, [2, 3]], "s": (_ h'0102', h'03'), "t": (_ "ab", "c")}
+    static constexpr auto TEST_DATA = 0xbf61619f01820203ff61735f4201024103ff61747f6261626163ffff_bytes;
+
+    // {"a": [1, [2, 3]], "s": h'010203', "t": "abc"}
+    static constexpr auto DEFINITE = 0xa361618201820203617343010203617463616263_bytes;
+
+    CBOR::DynamicDataModel expected;
+    ASSERT_EQ(CBOR::decode(expected, DEFINITE).first, CBOR::Error::OK);
+    const auto expectedString = expected.root().toString();
+
+    for (const auto lazy : { false, true })
+    {
+        CBOR::DynamicDataModel model;
+        ASSERT_EQ(CBOR::decode(model, TEST_DATA, CBOR::DecodeOptions{ .lazy = lazy, .borrow = true }),
+            std::make_pair(CBOR::Error::OK, TEST_DATA.size()));
+        EXPECT_EQ(model.root().size(), 3);
+        EXPECT_EQ(model.root()[0].size(), 2);
+        EXPECT_EQ(model.root().toString(), expectedString);
+
+        // the chunks are coalesced into one blob, even when borrowing
+        EXPECT_FALSE(model.root()[1].isBorrowed());
+        EXPECT_EQ(std::string_view(model.root()[2].toTextString().data(), 3), "abc");
+    }
+
+    // fed in chunks of every size
+    for (size_t chunk = 1; chunk <= TEST_DATA.size(); ++chunk)
+    {
+        CBOR::DynamicDataModel model;
+        CBOR::Decoder decoder(model);
+
+        auto result = std::make_pair(CBOR::Error::UNEXPECTED_EOF, size_t(0));
+        for (size_t offset = 0; offset < TEST_DATA.size(); offset += chunk)
+        {
+            result = decoder.feed(std::span<const uint8_t>(TEST_DATA.data() + offset, std::min(chunk, TEST_DATA.size() - offset)));
+            ASSERT_TRUE(result.first == CBOR::Error::OK || result.first == CBOR::Error::UNEXPECTED_EOF);
+        }
+
+        ASSERT_EQ(result.first, CBOR::Error::OK);
+        EXPECT_EQ(model.root().toString(), expectedString);
+    }
+
+    CBOR::Reader reader(TEST_DATA);
+    EXPECT_EQ(reader.skip(), CBOR::Error::OK);
+    EXPECT_TRUE(reader.atEnd());
+
+    static constexpr auto ARRAY = 0x9f01820203ff_bytes;
+    CBOR::Reader array(ARRAY);
+    EXPECT_EQ(array.enterContainer(), std::make_pair(CBOR::Error::OK, CBOR::INDEFINITE_LENGTH));
+    EXPECT_EQ(array.readBreak(), CBOR::Error::UNEXPECTED_TYPE);
+    EXPECT_EQ(array.readInt(), std::make_pair(CBOR::Error::OK, INT64_C(1)));
+    EXPECT_EQ(array.skip(), CBOR::Error::OK);
+    EXPECT_EQ(array.readBreak(), CBOR::Error::OK);
+    EXPECT_TRUE(array.atEnd());
+
+    RecordingHandler handler;
+    EXPECT_EQ(CBOR::decodeEvents(ARRAY, handler), std::make_pair(CBOR::Error::OK, ARRAY.size()));
+    EXPECT_EQ(handler.events, "[1,[2,3]]");
+
+    // misplaced breaks, a map ending after a key and chunks that are not definite strings of the same type
+    const std::vector<std::vector<uint8_t>> MALFORMED = { { 0xff }, { 0x82, 0x01, 0xff }, { 0xbf, 0x61, 0x61, 0xff },
+        { 0x5f, 0x61, 0x61, 0xff }, { 0x7f, 0x7f, 0x61, 0x61, 0xff, 0xff }, { 0x9f, 0xc0, 0xff } };
+    for (const auto& bytes : MALFORMED)
+    {
+        CBOR::DynamicDataModel model;
+        EXPECT_EQ(CBOR::decode(model, bytes).first, CBOR::Error::MALFORMED_MESSAGE);
+
+        CBOR::Reader malformed(bytes);
+        EXPECT_EQ(malformed.skip(), CBOR::Error::MALFORMED_MESSAGE);
+    }
+}
+
+TEST(CBOR, Encoder_ShortestFloats)
+{
+    // [1.5, 100000.0, 1.1] in double precision
+    static constexpr auto TEST_DATA = 0x83fb3ff8000000000000fb40f86a0000000000fb3ff199999999999a_bytes;
+
+    // [1.5, 100000.0, 1.1] in half, single and double precision
+    static constexpr auto SHORTEST = 0x83f93e00fa47c35000fb3ff199999999999a_bytes;
+
+    CBOR::DynamicDataModel model;
+    ASSERT_EQ(CBOR::decode(model, TEST_DATA).first, CBOR::Error::OK);
+
+    std::array<uint8_t, TEST_DATA.size()> encoded{0};
+    ASSERT_EQ(CBOR::encode(model, encoded), std::make_pair(CBOR::Error::OK, TEST_DATA.size()));
+    EXPECT_EQ(encoded, TEST_DATA);
+
+    std::array<uint8_t, SHORTEST.size()> shortest{0};
+    ASSERT_EQ(CBOR::encode(model, shortest, CBOR::EncodeOptions{ .shortestFloats = true }), std::make_pair(CBOR::Error::OK, SHORTEST.size()));
+    EXPECT_EQ(shortest, SHORTEST);
+
+    // all decoders read half precision
+    CBOR::DynamicDataModel decoded;
+    ASSERT_EQ(CBOR::decode(decoded, SHORTEST).first, CBOR::Error::OK);
+    EXPECT_EQ(decoded.root()[0].toFloat(), 1.5);
+    EXPECT_EQ(decoded.root().toString(), model.root().toString());
+
+    CBOR::Reader reader(SHORTEST);
+    EXPECT_EQ(reader.enterContainer().second, 3);
+    EXPECT_EQ(reader.readFloat(), std::make_pair(CBOR::Error::OK, 1.5));
+
+    RecordingHandler handler;
+    EXPECT_EQ(CBOR::decodeEvents(SHORTEST, handler).first, CBOR::Error::OK);
+    EXPECT_EQ(handler.events, "[1.500000,100000.000000,1.100000]");
+}
+
+TEST(CBOR, Measure)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    const auto [error, measurement] = CBOR::measure(TEST_DATA);
+    ASSERT_EQ(error, CBOR::Error::OK);
+    EXPECT_EQ(measurement.items, 15);
+    EXPECT_EQ(measurement.blobBytes, 18);
+    EXPECT_EQ(measurement.maxDepth, 3);
+    EXPECT_EQ(measurement.size, TEST_DATA.size());
+
+    // the numbers match a decode, an exactly sized static model suffices
+    CBOR::DynamicDataModel model;
+    ASSERT_EQ(model.reserve(measurement.items, measurement.blobBytes), CBOR::Error::OK);
+    ASSERT_EQ(CBOR::decode(model, TEST_DATA).first, CBOR::Error::OK);
+    EXPECT_EQ(model.itemAllocator().size(), measurement.items);
+    EXPECT_EQ(model.blobAllocator().size(), measurement.blobBytes);
+
+    CBOR::StaticDataModel<15, 18> exact;
+    ASSERT_EQ(exact.reserve(measurement.items, measurement.blobBytes), CBOR::Error::OK);
+    ASSERT_EQ(CBOR::decode(exact, TEST_DATA).first, CBOR::Error::OK);
+    EXPECT_EQ(exact.root().toString(), model.root().toString());
+
+    CBOR::StaticDataModel<14, 18> tooSmall;
+    EXPECT_EQ(tooSmall.reserve(measurement.items, measurement.blobBytes), CBOR::Error::ITEM_ALLOC_FAILED);
+
+    // {_ "a": [_ 1, [2, 3]], "s": (_ h'0102', h'03'), "t": (_ "ab", "c")} followed by another message
+    static constexpr auto INDEFINITE = 0xbf61619f01820203ff61735f4201024103ff61747f6261626163ffff00_bytes;
+    const auto indefinite = CBOR::measure(INDEFINITE);
+    ASSERT_EQ(indefinite.first, CBOR::Error::OK);
+    EXPECT_EQ(indefinite.second.items, 11);
+    EXPECT_EQ(indefinite.second.blobBytes, 9);
+    EXPECT_EQ(indefinite.second.maxDepth, 3);
+    EXPECT_EQ(indefinite.second.size, INDEFINITE.size() - 1);
+
+    // nesting beyond the inline levels
+    std::vector<uint8_t> deep(1000, 0x81);
+    deep.back() = 0x80;
+    EXPECT_EQ(CBOR::measure(deep).second.maxDepth, 1000);
+
+    static constexpr auto HUGE = 0x9bffffffffffffffff01_bytes;
+    EXPECT_EQ(CBOR::measure(HUGE).first, CBOR::Error::UNEXPECTED_EOF);
+}
+
+TEST(CBOR, Decode_Sequence)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    CBOR::DynamicDataModel expected;
+    ASSERT_EQ(CBOR::decode(expected, TEST_DATA).first, CBOR::Error::OK);
+    const auto expectedString = expected.root().toString();
+
+    // enough items for several shards, every 100th is an integer
+    constexpr size_t ITEMS = 20000;
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < ITEMS; ++i)
+    {
+        if (i % 100 == 0)
+        {
+            data.push_back(0x19);
+            data.push_back((uint8_t)((i + 1000) >> 8));
+            data.push_back((uint8_t)(i + 1000));
+        }
+        else
+        {
+            data.insert(data.end(), TEST_DATA.begin(), TEST_DATA.end());
+        }
+    }
+
+    for (const size_t threads : { 1, 4 })
+    {
+        CBOR::Sequence sequence;
+        ASSERT_EQ(CBOR::decodeSequence(data, sequence, threads), std::make_pair(CBOR::Error::OK, data.size()));
+        ASSERT_EQ(sequence.size(), ITEMS);
+        EXPECT_GT(sequence.shards(), 1);
+
+        auto items = sequence.items();
+        ASSERT_EQ(items.size(), ITEMS);
+        for (size_t i = 0; i < ITEMS; ++i)
+        {
+            if (i % 100 == 0)
+            {
+                ASSERT_EQ(items[i].toInt(), (int64_t)(i + 1000));
+            }
+            else
+            {
+                ASSERT_EQ(items[i].toString(), expectedString);
+            }
+        }
+    }
+
+    // a truncated last item does not affect the items before it
+    const auto complete = data.size();
+    data.insert(data.end(), TEST_DATA.begin(), TEST_DATA.begin() + 10);
+
+    CBOR::Sequence sequence;
+    EXPECT_EQ(CBOR::decodeSequence(data, sequence, 4), std::make_pair(CBOR::Error::UNEXPECTED_EOF, complete));
+    EXPECT_EQ(sequence.size(), ITEMS);
+
+    // errors of the decoder are reported at their position
+    static constexpr auto BAD_KEY = 0x01a1800102_bytes;
+    EXPECT_EQ(CBOR::decodeSequence(BAD_KEY, sequence), std::make_pair(CBOR::Error::UNSUPPORTED_KEY_TYPE, size_t(3)));
+    EXPECT_EQ(sequence.size(), 0);
+
+    EXPECT_EQ(CBOR::decodeSequence({}, sequence), std::make_pair(CBOR::Error::OK, size_t(0)));
+
+    // the budgets apply to the whole sequence, whatever the number of threads
+    std::vector<uint8_t> pairs;
+    for (size_t i = 0; i < 100000; ++i)
+    {
+        pairs.insert(pairs.end(), { 0x82, 0x01, 0x02 });
+    }
+
+    const auto failed = CBOR::decodeSequence(pairs, sequence, 1, { .limits = { .maxItems = 70000 } });
+    EXPECT_EQ(failed.first, CBOR::Error::ITEM_LIMIT_EXCEEDED);
+    EXPECT_EQ(CBOR::decodeSequence(pairs, sequence, 4, { .limits = { .maxItems = 70000 } }), failed);
+    EXPECT_EQ(sequence.size(), 0);
+
+    ASSERT_EQ(CBOR::decodeSequence(pairs, sequence, 4, { .limits = { .maxItems = 400000 } }), std::make_pair(CBOR::Error::OK, pairs.size()));
+    EXPECT_EQ(sequence.size(), 100000);
+}
+
+TEST(CBOR, Decode_Parallel)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    // a tagged array, an array of indefinite length and a map, each large enough for several shards
+    constexpr size_t ELEMENTS = 20000;
+    std::vector<std::vector<uint8_t>> messages(3);
+    messages[0] = { 0xd8, 0x20, 0x9a, 0x00, 0x00, (uint8_t)(ELEMENTS >> 8), (uint8_t)ELEMENTS };
+    messages[1] = { 0x9f };
+    messages[2] = { 0xba, 0x00, 0x00, (uint8_t)(ELEMENTS >> 8), (uint8_t)ELEMENTS };
+    for (size_t i = 0; i < ELEMENTS; ++i)
+    {
+        const uint8_t key[] = { 0x19, (uint8_t)((i + 1000) >> 8), (uint8_t)(i + 1000) };
+        messages[2].insert(messages[2].end(), std::begin(key), std::end(key));
+
+        for (auto& message : messages)
+        {
+            message.insert(message.end(), TEST_DATA.begin(), TEST_DATA.end());
+        }
+    }
+
+    messages[1].push_back(0xff);
+
+    for (const auto& message : messages)
+    {
+        CBOR::DynamicDataModel expected;
+        ASSERT_EQ(CBOR::decode(expected, message), std::make_pair(CBOR::Error::OK, message.size()));
+
+        for (const size_t threads : { 1, 4 })
+        {
+            CBOR::DynamicDataModel model;
+            CBOR::Decoder decoder(model);
+            ASSERT_EQ(decoder.decodeParallel(message, threads), std::make_pair(CBOR::Error::OK, message.size()));
+            EXPECT_TRUE(decoder.complete());
+            EXPECT_EQ(model.root().tag(), expected.root().tag());
+            EXPECT_EQ(model.root().size(), expected.root().size());
+            EXPECT_EQ(model.root().toString(), expected.root().toString());
+
+            // the stitched children belong to the root
+            auto last = model.root().begin();
+            while (bool(last.sibling()))
+            {
+                last = last.sibling();
+            }
+
+            EXPECT_EQ(last.parent().size(), expected.root().size());
+            EXPECT_FALSE(bool(last.parent().parent()));
+            if (model.root().type() == CBOR::Type::MAP)
+            {
+                EXPECT_EQ(last.key().parent().size(), expected.root().size());
+            }
+        }
+    }
+
+    // elements are skip-scanned before any shard is decoded, a truncated one fails up front
+    CBOR::DynamicDataModel model;
+    CBOR::Decoder decoder(model);
+    const std::span<const uint8_t> truncated(messages[0].data(), messages[0].size() - 1);
+    EXPECT_EQ(decoder.decodeParallel(truncated, 4).first, CBOR::Error::UNEXPECTED_EOF);
+
+    // small messages and other roots are decoded serially
+    EXPECT_EQ(decoder.decodeParallel(TEST_DATA, 4), std::make_pair(CBOR::Error::OK, TEST_DATA.size()));
+    EXPECT_EQ(model.root().size(), 4);
+}
+
+TEST(CBOR, Validate)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+    EXPECT_EQ(CBOR::validate(TEST_DATA), std::make_pair(CBOR::Error::OK, TEST_DATA.size()));
+
+    // {_ "a": [_ 1, [2, 3]], "s": (_ h'0102', h'03'), "t": (_ "ab", "c")} followed by another message
+    static constexpr auto INDEFINITE = 0xbf61619f01820203ff61735f4201024103ff61747f6261626163ffff00_bytes;
+    EXPECT_EQ(CBOR::validate(INDEFINITE), std::make_pair(CBOR::Error::OK, INDEFINITE.size() - 1));
+
+    // messages and the error at the offending item
+    const std::vector<std::tuple<std::vector<uint8_t>, CBOR::Error, size_t>> cases = {
+        { { 0x82, 0x01, 0x62, 0xc3, 0x28 }, CBOR::Error::INVALID_UTF8, 2 },
+        { { 0x7f, 0x61, 0xc3, 0x61, 0xa9, 0xff }, CBOR::Error::INVALID_UTF8, 0 }, // a character split between chunks
+        { { 0x82, 0x18, 0x17 }, CBOR::Error::MALFORMED_ARGUMENT, 1 },
+        { { 0x82, 0x01 }, CBOR::Error::UNEXPECTED_EOF, 0 }, // fewer bytes than items
+        { { 0x82, 0x01, 0x81 }, CBOR::Error::UNEXPECTED_EOF, 2 },
+        { { 0x63, 0x61, 0x62 }, CBOR::Error::UNEXPECTED_EOF, 0 },
+        { { 0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01 }, CBOR::Error::UNEXPECTED_EOF, 0 },
+        { { 0x81, 0xff }, CBOR::Error::MALFORMED_MESSAGE, 1 },
+        { { 0xbf, 0x01, 0xff }, CBOR::Error::MALFORMED_MESSAGE, 2 },
+        { { 0x5f, 0x61, 0x61, 0xff }, CBOR::Error::MALFORMED_MESSAGE, 0 },
+        { { 0x1c }, CBOR::Error::MALFORMED_MESSAGE, 0 },
+        { { 0xa1, 0x80, 0x01 }, CBOR::Error::UNSUPPORTED_KEY_TYPE, 1 },
+        { { 0x81, 0xc0, 0xc0, 0x01 }, CBOR::Error::DOUBLE_TAGGED, 2 },
+        { { 0xe0 }, CBOR::Error::UNSUPPORTED_SIMPLE, 0 }
+    };
+
+    for (const auto& [message, error, position] : cases)
+    {
+        EXPECT_EQ(CBOR::validate(message), std::make_pair(error, position));
+
+        // the decoder agrees
+        CBOR::DynamicDataModel model;
+        EXPECT_EQ(CBOR::decode(model, message, { .validateUtf8 = true }).first, error);
+    }
+
+    // UTF-8 is only checked on request
+    static constexpr auto INVALID_UTF8 = 0x7f61c361a9ff_bytes;
+    EXPECT_EQ(CBOR::validate(INVALID_UTF8, { .utf8 = false }), std::make_pair(CBOR::Error::OK, INVALID_UTF8.size()));
+
+    CBOR::DynamicDataModel model;
+    EXPECT_EQ(CBOR::decode(model, INVALID_UTF8).first, CBOR::Error::OK);
+
+    // lazy containers check their strings when they are decoded
+    static constexpr auto LAZY = 0x818162c328_bytes;
+    ASSERT_EQ(CBOR::decode(model, LAZY, { .lazy = true, .validateUtf8 = true }).first, CBOR::Error::OK);
+    EXPECT_FALSE(bool(model.root().begin().begin()));
+    EXPECT_EQ(model.error(), CBOR::Error::INVALID_UTF8);
+
+    // nesting
+    std::vector<uint8_t> deep(1000, 0x81);
+    deep.back() = 0x80;
+    EXPECT_EQ(CBOR::validate(deep), std::make_pair(CBOR::Error::OK, deep.size()));
+    EXPECT_EQ(CBOR::validate(deep, { .maxDepth = 999 }), std::make_pair(CBOR::Error::MAXIMUM_DEPTH_EXCEEDED, size_t(999)));
+}
+
+TEST(CBOR, Path)
+{
+    // {"meta": {"id": 42, "name": "x"}, "samples": [{"value": 1, "t": 0}, {"value": 2.5}, {"t": 1}], 24: "int key"}
+    static constexpr auto TEST_DATA = 0xa3646d657461a2626964182a646e616d6561786773616d706c657383a26576616c756501617400a16576616c7565f94100a1617401181867696e74206b6579_bytes;
+    static constexpr auto INDEFINITE = 0xbf646d657461bf626964182a646e616d656178ff6773616d706c65739fbf6576616c756501617400ffbf6576616c7565f94100ffbf617401ffff181867696e74206b6579ff_bytes;
+
+    for (const auto data : { std::span<const uint8_t>(TEST_DATA), std::span<const uint8_t>(INDEFINITE) })
+    {
+        const auto query = [&data](std::string_view expression)
+        {
+            const auto [error, path] = CBOR::Path::compile(expression);
+            EXPECT_EQ(error, CBOR::Error::OK);
+
+            std::vector<std::span<const uint8_t>> matches;
+            EXPECT_EQ(CBOR::select(data, path, matches), CBOR::Error::OK);
+            return matches;
+        };
+
+        auto matches = query("$.meta.id");
+        ASSERT_EQ(matches.size(), 1);
+        EXPECT_EQ(CBOR::Reader(matches[0]).readInt(), std::make_pair(CBOR::Error::OK, int64_t(42)));
+
+        matches = query("$.samples[*].value");
+        ASSERT_EQ(matches.size(), 2);
+        EXPECT_EQ(CBOR::Reader(matches[0]).readInt().second, 1);
+        EXPECT_EQ(CBOR::Reader(matches[1]).readFloat().second, 2.5);
+
+        matches = query("$[\"samples\"][2]['t']");
+        ASSERT_EQ(matches.size(), 1);
+        EXPECT_EQ(CBOR::Reader(matches[0]).readInt().second, 1);
+
+        matches = query("$[24]");
+        ASSERT_EQ(matches.size(), 1);
+        EXPECT_EQ(CBOR::Reader(matches[0]).readText().second, "int key");
+
+        EXPECT_EQ(query("$.*").size(), 3);
+        EXPECT_EQ(query("$").size(), 1);
+        EXPECT_EQ(query("$.missing").size(), 0);
+        EXPECT_EQ(query("$.meta.id.deeper").size(), 0);
+        EXPECT_EQ(query("$.samples[3]").size(), 0);
+        EXPECT_EQ(query("$.samples[-1]").size(), 0);
+    }
+
+    // only the matches are decoded
+    const auto [error, path] = CBOR::Path::compile("$.samples[*].value");
+    ASSERT_EQ(error, CBOR::Error::OK);
+    EXPECT_FALSE(path.single());
+
+    CBOR::DynamicDataModel model;
+    ASSERT_EQ(CBOR::select(TEST_DATA, path, model), CBOR::Error::OK);
+    EXPECT_EQ(model.root().toString(), "[ 1, 2.500000 ]");
+    EXPECT_EQ(model.itemAllocator().size(), 3);
+
+    // a path without wildcards stops at its match, the rest of the message is not read
+    const auto single = CBOR::Path::compile("$.meta.id").second;
+    EXPECT_TRUE(single.single());
+
+    std::vector<std::span<const uint8_t>> matches;
+    EXPECT_EQ(CBOR::select(std::span<const uint8_t>(TEST_DATA).first(20), single, matches), CBOR::Error::OK);
+    EXPECT_EQ(matches.size(), 1);
+
+    // errors of the message
+    EXPECT_EQ(CBOR::select(std::span<const uint8_t>(TEST_DATA).first(30), path, matches), CBOR::Error::UNEXPECTED_EOF);
+
+    for (const auto expression : { "", "meta", "$.", "$..a", "$[", "$[1", "$[x]", "$[]", "$['a]", "$[\"a\"b]", "$a" })
+    {
+        EXPECT_EQ(CBOR::Path::compile(expression).first, CBOR::Error::MALFORMED_PATH) << expression;
+    }
+}
+
+TEST(CBOR, Decode_Limits)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    // the budgets of measure() are exactly sufficient
+    const auto measurement = CBOR::measure(TEST_DATA).second;
+    const auto decodeWith = [](std::span<const uint8_t> data, const CBOR::DecodeLimits& limits, bool borrow = false)
+    {
+        CBOR::DynamicDataModel model;
+        return CBOR::decode(model, data, { .borrow = borrow, .limits = limits }).first;
+    };
+
+    EXPECT_EQ(decodeWith(TEST_DATA, { .maxItems = measurement.items }), CBOR::Error::OK);
+    EXPECT_EQ(decodeWith(TEST_DATA, { .maxItems = measurement.items - 1 }), CBOR::Error::ITEM_LIMIT_EXCEEDED);
+    EXPECT_EQ(decodeWith(TEST_DATA, { .maxBlobBytes = measurement.blobBytes }), CBOR::Error::OK);
+    EXPECT_EQ(decodeWith(TEST_DATA, { .maxBlobBytes = measurement.blobBytes - 1 }), CBOR::Error::BLOB_LIMIT_EXCEEDED);
+    EXPECT_EQ(decodeWith(TEST_DATA, { .maxBlobBytes = 0 }, true), CBOR::Error::OK);
+    EXPECT_EQ(decodeWith(TEST_DATA, { .maxStringLength = 10 }), CBOR::Error::OK);
+    EXPECT_EQ(decodeWith(TEST_DATA, { .maxStringLength = 9 }), CBOR::Error::STRING_TOO_LONG);
+
+    // items of containers of indefinite length and chunks of strings of indefinite length
+    static constexpr auto INDEFINITE = 0x9f010203ff_bytes;
+    EXPECT_EQ(decodeWith(INDEFINITE, { .maxItems = 4 }), CBOR::Error::OK);
+    EXPECT_EQ(decodeWith(INDEFINITE, { .maxItems = 3 }), CBOR::Error::ITEM_LIMIT_EXCEEDED);
+
+    static constexpr auto CHUNKED = 0x5f4201024103ff_bytes;
+    EXPECT_EQ(decodeWith(CHUNKED, { .maxStringLength = 3 }), CBOR::Error::OK);
+    EXPECT_EQ(decodeWith(CHUNKED, { .maxStringLength = 2 }), CBOR::Error::STRING_TOO_LONG);
+
+    // a declared length fails at the header, before anything is allocated
+    static constexpr auto HOSTILE = 0x9affffffff01_bytes;
+    CBOR::StaticDataModel<16, 16> model;
+    EXPECT_EQ(CBOR::decode(model, HOSTILE, { .limits = { .maxItems = 1000 } }), std::make_pair(CBOR::Error::ITEM_LIMIT_EXCEEDED, size_t(5)));
+    EXPECT_EQ(model.itemAllocator().size(), 0);
+
+    // and without waiting for the payload when feeding
+    static constexpr auto HUGE_STRING = 0x5a7fffffff_bytes;
+    CBOR::DynamicDataModel fed;
+    CBOR::Decoder decoder(fed, CBOR::DecodeOptions{ .limits = { .maxStringLength = 1024 } });
+    EXPECT_EQ(decoder.feed(HUGE_STRING).first, CBOR::Error::STRING_TOO_LONG);
+
+    // the budgets are per message
+    decoder.setLimits({ .maxItems = 4 });
+    EXPECT_EQ(decoder.decode(INDEFINITE).first, CBOR::Error::OK);
+    EXPECT_EQ(decoder.decode(INDEFINITE).first, CBOR::Error::OK);
+    EXPECT_EQ(decoder.decodeSequence(0x010203_bytes, 3).first, CBOR::Error::OK);
+    EXPECT_EQ(decoder.decodeSequence(0x01020304_bytes, 4).first, CBOR::Error::ITEM_LIMIT_EXCEEDED);
+
+    // lazy containers are decoded within the limits of the message
+    static constexpr auto NESTED = 0x818166616263646566_bytes;
+    CBOR::DynamicDataModel lazy;
+    ASSERT_EQ(CBOR::decode(lazy, NESTED, { .lazy = true, .limits = { .maxStringLength = 3 } }).first, CBOR::Error::OK);
+    EXPECT_FALSE(bool(lazy.root().begin().begin()));
+    EXPECT_EQ(lazy.error(), CBOR::Error::STRING_TOO_LONG);
+
+    const auto past = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    EXPECT_EQ(decodeWith(TEST_DATA, { .deadline = past }), CBOR::Error::DEADLINE_EXCEEDED);
+    EXPECT_EQ(decodeWith(TEST_DATA, { .deadline = std::chrono::steady_clock::now() + std::chrono::hours(1) }), CBOR::Error::OK);
+}
+
+TEST(CBOR, DataModel_Reset)
+{
+    // {"a": [1, 1000, -2], 24: h'0102', "text": 0("2013-03-21"), "n": [null, true, {}]}
+    static constexpr auto TEST_DATA = 0xa4616183011903e82118184201026474657874c06a323031332d30332d3231616e83f6f5a0_bytes;
+
+    // a reused model decodes into the memory of the previous message
+    CBOR::DynamicDataModel model;
+    ASSERT_EQ(CBOR::decode(model, TEST_DATA).first, CBOR::Error::OK);
+    const auto expected = model.root().toString();
+    const auto* blob = model.root().begin().key().toTextString().data();
+    const auto retainedItems = model.itemAllocator().retained();
+    const auto retainedBytes = model.blobAllocator().retained();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(CBOR::decode(model, TEST_DATA).first, CBOR::Error::OK);
+        ASSERT_EQ(model.root().toString(), expected);
+        ASSERT_EQ(model.root().begin().key().toTextString().data(), blob);
+        ASSERT_EQ(model.itemAllocator().size(), 15);
+    }
+
+    EXPECT_EQ(model.itemAllocator().retained(), retainedItems);
+    EXPECT_EQ(model.blobAllocator().retained(), retainedBytes);
+
+    // the memory of a larger message is released by a shrink after a smaller one
+    std::vector<uint8_t> large = { 0x99, 0x27, 0x10 };
+    for (int i = 0; i < 10000; ++i)
+    {
+        large.insert(large.end(), { 0x63, 'a', 'b', 'c' });
+    }
+
+    ASSERT_EQ(CBOR::decode(model, large).first, CBOR::Error::OK);
+    EXPECT_GE(model.itemAllocator().retained(), 10001);
+    EXPECT_GE(model.blobAllocator().retained(), 30000);
+
+    model.reset(CBOR::ResetPolicy::SHRINK);
+    EXPECT_GE(model.itemAllocator().retained(), 10001);
+
+    ASSERT_EQ(CBOR::decode(model, TEST_DATA).first, CBOR::Error::OK);
+    model.reset(CBOR::ResetPolicy::SHRINK);
+    EXPECT_EQ(model.itemAllocator().retained(), retainedItems);
+    EXPECT_EQ(model.blobAllocator().retained(), retainedBytes);
+
+    ASSERT_EQ(CBOR::decode(model, TEST_DATA).first, CBOR::Error::OK);
+    EXPECT_EQ(model.root().toString(), expected);
+
+    // a message that fails leaves no root of the previous one behind
+    static constexpr auto ARRAY = 0x83010203_bytes;
+    static constexpr auto BREAK = 0xff_bytes;
+    ASSERT_EQ(CBOR::decode(model, ARRAY).first, CBOR::Error::OK);
+    ASSERT_NE(CBOR::decode(model, BREAK).first, CBOR::Error::OK);
+    EXPECT_FALSE(bool(model.root()));
+
+    model.clear();
+    EXPECT_EQ(model.itemAllocator().retained(), 0);
+
+    // items of a previous message do not leak into new ones
+    CBOR::StaticDataModel<16, 64> reused;
+    ASSERT_EQ(CBOR::decode(reused, TEST_DATA).first, CBOR::Error::OK);
+    auto root = reused.createEmpty(CBOR::Type::ARRAY);
+    EXPECT_EQ(root.size(), 0);
+    EXPECT_EQ(root.tag(), CBOR::Tag::INVALID);
+}
+
+TEST(CBOR, Decode_Sink)
+{
+    // {"id": 7, "image": h'00 01 02 ...' (100000 bytes), "text": "é" * 40000}
+    std::vector<uint8_t> image(100000);
+    for (size_t i = 0; i < image.size(); ++i)
+    {
+        image[i] = uint8_t(i);
+    }
+
+    std::vector<uint8_t> text;
+    for (int i = 0; i < 40000; ++i)
+    {
+        text.insert(text.end(), { 0xc3, 0xa9 });
+    }
+
+    std::vector<uint8_t> message = { 0xa3, 0x62, 'i', 'd', 0x07, 0x65, 'i', 'm', 'a', 'g', 'e', 0x5a, 0x00, 0x01, 0x86, 0xa0 };
+    message.insert(message.end(), image.begin(), image.end());
+    message.insert(message.end(), { 0x64, 't', 'e', 'x', 't', 0x7a, 0x00, 0x01, 0x38, 0x80 });
+    message.insert(message.end(), text.begin(), text.end());
+
+    std::vector<uint8_t> expected = image;
+    expected.insert(expected.end(), text.begin(), text.end());
+
+    // the model only keeps placeholders, the blob allocator holds the keys
+    const auto check = [&](CBOR::DynamicDataModel& model, const DynamicOutputBuffer& sink)
+    {
+        auto id = model.root().begin();
+        auto imageItem = id.sibling();
+        auto textItem = imageItem.sibling();
+        EXPECT_EQ(id.toInt(), 7);
+        EXPECT_TRUE(imageItem.isSunk());
+        EXPECT_EQ(imageItem.size(), image.size());
+        EXPECT_EQ(imageItem.sinkOffset(), 0);
+        EXPECT_TRUE(imageItem.toByteString().empty());
+        EXPECT_TRUE(textItem.isSunk());
+        EXPECT_EQ(textItem.type(), CBOR::Type::STRING);
+        EXPECT_EQ(textItem.size(), text.size());
+        EXPECT_EQ(textItem.sinkOffset(), image.size());
+        EXPECT_TRUE(textItem.key().isSunk() == false);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), sink.data(), sink.data() + sink.size()));
+    };
+
+    DynamicOutputBuffer sink;
+    CBOR::DynamicDataModel model;
+    const CBOR::DecodeOptions options{ .validateUtf8 = true, .limits = { .maxBlobBytes = 16 }, .sink = &sink };
+    ASSERT_EQ(CBOR::decode(model, message, options), std::make_pair(CBOR::Error::OK, message.size()));
+    check(model, sink);
+
+    // fed in chunks that split the sequences of the text, the payload reaches the sink as it arrives
+    DynamicOutputBuffer fedSink;
+    CBOR::DynamicDataModel fed;
+    CBOR::Decoder decoder(fed, CBOR::DecodeOptions{ .validateUtf8 = true, .sink = &fedSink });
+    for (size_t offset = 0; offset < message.size(); offset += 999)
+    {
+        const auto chunk = std::span<const uint8_t>(message).subspan(offset, std::min<size_t>(999, message.size() - offset));
+        const auto [error, used] = decoder.feed(chunk);
+        ASSERT_EQ(used, chunk.size());
+        ASSERT_EQ(error, offset + chunk.size() < message.size() ? CBOR::Error::UNEXPECTED_EOF : CBOR::Error::OK);
+        ASSERT_GE(fedSink.size() + 2 * 999, std::min(offset, expected.size()));
+    }
+
+    check(fed, fedSink);
+
+    // strings up to the threshold are decoded as usual, as is a chunked string above it
+    DynamicOutputBuffer small;
+    ASSERT_EQ(CBOR::decode(model, message, { .sink = &small, .sinkThreshold = image.size() }).first, CBOR::Error::OK);
+    EXPECT_EQ(model.root().begin().sibling().toByteString().size(), image.size());
+    EXPECT_TRUE(model.root().begin().sibling().sibling().isSunk() == false);
+    EXPECT_EQ(small.size(), 0);
+
+    static constexpr auto CHUNKED = 0x5f4401020304430506074108ff_bytes;
+    ASSERT_EQ(CBOR::decode(model, CHUNKED, { .sink = &small, .sinkThreshold = 4 }).first, CBOR::Error::OK);
+    EXPECT_TRUE(model.root().isSunk());
+    EXPECT_EQ(model.root().size(), 8);
+    EXPECT_EQ(small.size(), 8);
+    EXPECT_EQ(small.data()[7], 0x08);
+
+    // invalid UTF-8 at the end of a sunk text, and a sink that is full
+    message.back() = 0xc3;
+    DynamicOutputBuffer invalid;
+    EXPECT_EQ(CBOR::decode(model, message, { .validateUtf8 = true, .sink = &invalid }).first, CBOR::Error::INVALID_UTF8);
+
+    std::vector<uint8_t> storage(1000);
+    SpanOutputBuffer full(storage);
+    EXPECT_EQ(CBOR::decode(model, message, { .sink = &full }).first, CBOR::Error::SINK_WRITE_FAILED);
 }
\ No newline at end of file
@@ -2,11 +2,18 @@
 
 #include <cstdint>
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <limits>
 #include <string_view>
+#include <vector>
 
 #include <cbor/Encoding.h>
 #include <cbor/Decoding.h>
+#include <cbor/InitTable.h>
+#include "Float16.h"
+#include "Utf8.h"
 
 using namespace std::literals;
 using namespace Bytes::Literals;
@@ -290,4 +297,316 @@ TEST(CBOR_Encoding, Encode_Decode_Tagged)
             EXPECT_TRUE(header.payload().empty());
         }
     }
+}
+
+static_assert(InputSource<SpanInputBuffer>);
+static_assert(InputSource<InputBuffer>);
+static_assert(OutputSink<SpanOutputBuffer>);
+static_assert(OutputSink<DynamicOutputBuffer>);
+static_assert(OutputSink<OutputBuffer>);
+
+TEST(CBOR_Encoding, Encode_Decode_TypeErased)
+{
+    constexpr auto INT = INT64_C(0x12345678);
+
+    std::array<uint8_t, 16> inlined{0};
+    std::array<uint8_t, 16> erased{0};
+
+    // Encode with the concrete buffer and through the type-erased interface
+    {
+        SpanOutputBuffer buffer(inlined);
+        ASSERT_EQ(CBOR::Encoding::encode(buffer, INT), CBOR::Error::OK);
+        ASSERT_EQ(buffer.size(), 5);
+    }
+
+    {
+        SpanOutputBuffer buffer(erased);
+        OutputBuffer& base = buffer;
+        ASSERT_EQ(CBOR::Encoding::encode(base, INT), CBOR::Error::OK);
+        ASSERT_EQ(buffer.size(), 5);
+    }
+
+    EXPECT_EQ(inlined, erased);
+
+    // Decode through the type-erased interface
+    {
+        SpanInputBuffer buffer(erased);
+        InputBuffer& base = buffer;
+        const auto [error, header] = CBOR::Decoding::decode(base);
+        ASSERT_EQ(error, CBOR::Error::OK);
+
+        EXPECT_EQ(header.majorType(), CBOR::MajorType::UNSIGNED_INT);
+        EXPECT_EQ(header.argument(), (uint64_t)INT);
+    }
+}
+
+TEST(CBOR_Encoding, Bytes_Swap)
+{
+    static_assert(Bytes::byteswap(UINT32_C(0x12345678)) == UINT32_C(0x78563412));
+    static_assert(Bytes::getBytes((uint16_t)0x1234, Bytes::Endianess::BIG) == std::array<uint8_t, 2>{0x12, 0x34});
+
+    // every length up to a few vectors, so that all kernels and their scalar tails are exercised
+    for (size_t count = 0; count < 70; ++count)
+    {
+        std::vector<uint64_t> values(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = UINT64_C(0x0102030405060708) * (i + 1);
+        }
+
+        std::vector<uint8_t> bytes(count * sizeof(uint64_t));
+        ASSERT_EQ(Bytes::store<uint64_t>(values, bytes, Bytes::Endianess::BIG), count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64_t expected = 0;
+            for (size_t j = 0; j < sizeof(uint64_t); ++j)
+            {
+                expected = (expected << 8) | bytes[i * sizeof(uint64_t) + j];
+            }
+
+            ASSERT_EQ(expected, values[i]);
+        }
+
+        std::vector<uint64_t> loaded(count);
+        ASSERT_EQ(Bytes::load<uint64_t>(bytes, loaded, Bytes::Endianess::BIG), count);
+        ASSERT_EQ(loaded, values);
+
+        // 16 and 32 bit views of the same bytes swap back to the original order twice
+        std::vector<uint16_t> shorts(count * 4);
+        Bytes::load<uint16_t>(bytes, shorts, Bytes::Endianess::BIG);
+        Bytes::convert<uint16_t>(shorts, Bytes::Endianess::BIG);
+        ASSERT_TRUE(std::equal(bytes.begin(), bytes.end(), (const uint8_t*)shorts.data()));
+
+        std::vector<uint32_t> words(count * 2);
+        Bytes::load<uint32_t>(bytes, words, Bytes::Endianess::BIG);
+        Bytes::convert<uint32_t>(words, Bytes::Endianess::BIG);
+        ASSERT_TRUE(std::equal(bytes.begin(), bytes.end(), (const uint8_t*)words.data()));
+    }
+}
+
+TEST(CBOR_Encoding, Encode_Float_NetworkOrder)
+{
+    std::array<uint8_t, 16> data{0};
+    SpanOutputBuffer buffer(data);
+
+    ASSERT_EQ(CBOR::Encoding::encode(buffer, 1.5f), CBOR::Error::OK);
+    ASSERT_EQ(CBOR::Encoding::encode(buffer, -4.1), CBOR::Error::OK);
+
+    constexpr auto expected = 0xfa3fc00000fbc010666666666666_bytes;
+    ASSERT_EQ(buffer.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), data.begin()));
+}
+
+TEST(CBOR_Encoding, Encode_TypedArray)
+{
+    const std::array<int32_t, 3> values = { 1, -2, 0x01020304 };
+
+    std::array<uint8_t, 32> data{0};
+    SpanOutputBuffer buffer(data);
+    ASSERT_EQ(CBOR::Encoding::encodeTypedArray(buffer, std::span<const int32_t>(values)), CBOR::Error::OK);
+
+    SpanInputBuffer input(std::span<const uint8_t>(data.data(), buffer.size()));
+    {
+        const auto [error, header] = CBOR::Decoding::decode(input);
+        ASSERT_EQ(error, CBOR::Error::OK);
+        EXPECT_EQ(header.majorType(), CBOR::MajorType::TAGGED);
+        EXPECT_EQ((CBOR::Tag)header.argument(), CBOR::Tag::TYPED_ARRAY_INT32_BIG);
+    }
+
+    const auto [error, header] = CBOR::Decoding::decode(input);
+    ASSERT_EQ(error, CBOR::Error::OK);
+    ASSERT_EQ(header.majorType(), CBOR::MajorType::BYTE_STRING);
+    ASSERT_EQ(header.payload().size(), sizeof(values));
+    EXPECT_EQ(header.payload()[3], 0x01);
+    EXPECT_EQ(header.payload()[11], 0x04);
+
+    std::array<int32_t, 3> decoded{0};
+    ASSERT_EQ(Bytes::load<int32_t>(header.payload(), decoded, Bytes::Endianess::BIG), decoded.size());
+    EXPECT_EQ(decoded, values);
+
+    static_assert(CBOR::Encoding::Detail::typedArrayTag<uint8_t>(Bytes::Endianess::LITTLE) == CBOR::Tag::TYPED_ARRAY_UINT8);
+    static_assert(CBOR::Encoding::Detail::typedArrayTag<uint64_t>(Bytes::Endianess::LITTLE) == CBOR::Tag::TYPED_ARRAY_UINT64_LITTLE);
+    static_assert(CBOR::Encoding::Detail::typedArrayTag<double>(Bytes::Endianess::BIG) == CBOR::Tag::TYPED_ARRAY_FLOAT64_BIG);
+    static_assert(CBOR::Encoding::Detail::typedArrayTag<float>(Bytes::Endianess::LITTLE) == CBOR::Tag::TYPED_ARRAY_FLOAT32_LITTLE);
+}
+
+TEST(CBOR_Encoding, Decode_InitTable)
+{
+    static_assert(CBOR::INIT_TABLE[0x17].kind == CBOR::InitKind::UNSIGNED_INT && CBOR::INIT_TABLE[0x17].argumentLength == 0);
+    static_assert(CBOR::INIT_TABLE[0x1b].argumentLength == 8 && CBOR::INIT_TABLE[0x1b].minimum == 24);
+    static_assert(CBOR::INIT_TABLE[0x1c].kind == CBOR::InitKind::MALFORMED);
+    static_assert(CBOR::INIT_TABLE[0x5f].kind == CBOR::InitKind::INDEFINITE);
+    static_assert(CBOR::INIT_TABLE[0x78].payload == CBOR::PayloadRule::LENGTH);
+    static_assert(CBOR::INIT_TABLE[0xf8].kind == CBOR::InitKind::SIMPLE && CBOR::INIT_TABLE[0xf8].minimum == 32);
+    static_assert(CBOR::INIT_TABLE[0xfa].kind == CBOR::InitKind::FLOAT && CBOR::INIT_TABLE[0xfa].payload == CBOR::PayloadRule::ARGUMENT);
+    static_assert(CBOR::INIT_TABLE[0xff].kind == CBOR::InitKind::BREAK);
+
+    // every argument width, once at the end of the message (byte-wise load) and once followed by padding (word load)
+    const std::array<uint64_t, 4> values = { 0xab, 0xabcd, 0xabcdef01, UINT64_C(0xabcdef0123456789) };
+    for (const auto value : values)
+    {
+        std::array<uint8_t, 16> data{0};
+        SpanOutputBuffer buffer(data);
+        ASSERT_EQ(CBOR::Encoding::encode(buffer, CBOR::MajorType::UNSIGNED_INT, value), CBOR::Error::OK);
+
+        for (const auto size : { buffer.size(), data.size() })
+        {
+            SpanInputBuffer input(std::span<const uint8_t>(data.data(), size));
+            const auto [error, header] = CBOR::Decoding::decode(input);
+            ASSERT_EQ(error, CBOR::Error::OK);
+            EXPECT_EQ(header.argument(), value);
+            EXPECT_EQ(input.size(), buffer.size());
+        }
+    }
+
+    // arguments that fit in fewer bytes are malformed
+    const std::array<uint8_t, 9> overlong = { 0x1b, 0, 0, 0, 0, 0, 0, 0, 0x17 };
+    SpanInputBuffer input(overlong);
+    EXPECT_EQ(CBOR::Decoding::decode(input).first, CBOR::Error::MALFORMED_ARGUMENT);
+}
+
+TEST(CBOR_Encoding, Float16_Conversion)
+{
+    // every half converts exactly and back, NaNs are quieted
+    for (uint32_t i = 0; i <= UINT16_MAX; ++i)
+    {
+        const auto half = (uint16_t)i;
+        const auto value = Float16::toFloat(half);
+        ASSERT_EQ(std::bit_cast<uint32_t>(value), std::bit_cast<uint32_t>(Float16::Detail::toFloat(half)));
+
+        const auto isNan = (half & 0x7c00) == 0x7c00 && (half & 0x3ff) != 0;
+        ASSERT_EQ(Float16::fromFloat(value), isNan ? half | 0x200 : half);
+    }
+
+    // rounding of the portable conversion matches the dispatched one (F16C on most machines)
+    for (uint64_t i = 0; i <= UINT32_MAX; i += 65521)
+    {
+        const auto value = std::bit_cast<float>((uint32_t)i);
+        ASSERT_EQ(Float16::fromFloat(value), Float16::Detail::fromFloat(value));
+    }
+
+    static_assert(Float16::Detail::fromFloat(1.5f) == 0x3e00);
+    static_assert(Float16::Detail::fromFloat(65504.0f) == 0x7bff);
+    static_assert(Float16::Detail::fromFloat(65520.0f) == 0x7c00);
+    static_assert(Float16::Detail::fromFloat(0x1p-24f) == 0x0001);
+    static_assert(Float16::Detail::fromFloat(0x1p-25f) == 0x0000);
+    static_assert(Float16::Detail::toFloat(0xc400) == -4.0f);
+
+    std::vector<float> values(37);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = (float)i * 0.25f - 3.0f;
+    }
+
+    std::vector<uint16_t> halfs(values.size());
+    std::vector<float> converted(values.size());
+    ASSERT_EQ(Float16::fromFloat(values, halfs), values.size());
+    ASSERT_EQ(Float16::toFloat(halfs, converted), values.size());
+    EXPECT_EQ(converted, values);
+}
+
+TEST(CBOR_Encoding, Encode_Float_Shortest)
+{
+    const auto encode = [](double value)
+    {
+        std::array<uint8_t, 16> data{0};
+        SpanOutputBuffer buffer(data);
+        EXPECT_EQ(CBOR::Encoding::encodeShortest(buffer, value), CBOR::Error::OK);
+        return std::vector<uint8_t>(data.begin(), data.begin() + buffer.size());
+    };
+
+    EXPECT_EQ(encode(1.5), std::vector<uint8_t>({ 0xf9, 0x3e, 0x00 }));
+    EXPECT_EQ(encode(-0.0), std::vector<uint8_t>({ 0xf9, 0x80, 0x00 }));
+    EXPECT_EQ(encode(std::numeric_limits<double>::infinity()), std::vector<uint8_t>({ 0xf9, 0x7c, 0x00 }));
+    EXPECT_EQ(encode(std::numeric_limits<double>::quiet_NaN()), std::vector<uint8_t>({ 0xf9, 0x7e, 0x00 }));
+    EXPECT_EQ(encode(100000.0), std::vector<uint8_t>({ 0xfa, 0x47, 0xc3, 0x50, 0x00 }));
+    EXPECT_EQ(encode(1.1), std::vector<uint8_t>({ 0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a }));
+
+    // a half decodes to the same value
+    const auto half = encode(5.960464477539063e-8);
+    ASSERT_EQ(half.size(), 3);
+
+    SpanInputBuffer input(half);
+    const auto [error, header] = CBOR::Decoding::decode(input);
+    ASSERT_EQ(error, CBOR::Error::OK);
+    EXPECT_EQ(header.argument(), (uint64_t)CBOR::FloatOrSimpleArgumentType::FLOAT16);
+    EXPECT_EQ(Float16::toFloat(Bytes::load<uint16_t>(header.payload().data(), Bytes::Endianess::NETWORK)), 0x1p-24f);
+}
+
+
+TEST(CBOR_Encoding, Utf8_Validation)
+{
+    const std::vector<std::pair<std::vector<uint8_t>, bool>> sequences = {
+        { { 'a' }, true },
+        { { 0xc2, 0xa9 }, true }, // U+00A9
+        { { 0xe2, 0x82, 0xac }, true }, // U+20AC
+        { { 0xef, 0xbf, 0xbf }, true }, // U+FFFF
+        { { 0xf0, 0x9f, 0x98, 0x80 }, true }, // U+1F600
+        { { 0xf4, 0x8f, 0xbf, 0xbf }, true }, // U+10FFFF
+        { { 0x80 }, false }, // continuation without a lead byte
+        { { 0xc0, 0xaf }, false }, // overlong
+        { { 0xc1, 0xbf }, false },
+        { { 0xe0, 0x9f, 0xbf }, false },
+        { { 0xf0, 0x8f, 0xbf, 0xbf }, false },
+        { { 0xed, 0xa0, 0x80 }, false }, // surrogate
+        { { 0xf4, 0x90, 0x80, 0x80 }, false }, // above U+10FFFF
+        { { 0xf5, 0x80, 0x80, 0x80 }, false },
+        { { 0xff }, false },
+        { { 0xc2 }, false }, // incomplete
+        { { 0xe2, 0x82 }, false },
+        { { 0xf0, 0x9f, 0x98 }, false },
+        { { 0xc2, 0x41 }, false }, // lead byte followed by ASCII
+        { { 0xe2, 0x82, 0xac, 0xac }, false } // too many continuation bytes
+    };
+
+    // every sequence at every position of a buffer spanning several vector blocks, at its end and followed by ASCII
+    for (const auto& [sequence, valid] : sequences)
+    {
+        for (size_t position = 0; position < 100; ++position)
+        {
+            for (const size_t trailer : { 0, 1, 40 })
+            {
+                std::vector<uint8_t> text(position, 'x');
+                text.insert(text.end(), sequence.begin(), sequence.end());
+                text.insert(text.end(), trailer, 'y');
+
+                ASSERT_EQ(Utf8::Detail::validate(text), valid);
+                ASSERT_EQ(Utf8::validate(text), valid) << "position " << position << ", trailer " << trailer;
+            }
+        }
+    }
+
+    // random text mostly made of valid characters agrees with the portable validation
+    uint32_t state = 1;
+    const auto random = [&state]()
+    {
+        state = state * 1664525 + 1013904223;
+        return state >> 8;
+    };
+
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        std::vector<uint8_t> text;
+        const auto length = random() % 200;
+        while (text.size() < length)
+        {
+            const auto& [sequence, valid] = sequences[random() % sequences.size()];
+            if (valid || random() % 16 == 0)
+            {
+                text.insert(text.end(), sequence.begin(), sequence.end());
+            }
+        }
+
+        ASSERT_EQ(Utf8::validate(text), Utf8::Detail::validate(text));
+        ASSERT_EQ(Utf8::validate(std::span<const char>((const char*)text.data(), text.size())), Utf8::Detail::validate(text));
+
+        // in two parts split anywhere, also within a sequence
+        Utf8::Validator validator;
+        const auto split = text.empty() ? 0 : random() % text.size();
+        const auto valid = validator.feed(std::span(text).first(split)) && validator.feed(std::span(text).subspan(split));
+        ASSERT_EQ(valid && validator.complete(), Utf8::Detail::validate(text)) << "split " << split;
+    }
+
+    static_assert(Utf8::Detail::validate(std::span<const uint8_t>()));
 }
\ No newline at end of file